@@ -0,0 +1,15 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+flat in float v_Layer;
+
+uniform vec4 u_Color;
+uniform sampler2DArray u_Textures;
+
+void main()
+{
+  // Same as Basic, but the texture is picked per vertex from an array
+  color = texture(u_Textures, vec3(v_TexCoord, v_Layer)) * u_Color;
+};
@@ -0,0 +1,17 @@
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in float layer;
+
+out vec2 v_TexCoord;
+flat out float v_Layer;
+
+uniform mat4 u_MVP; // MVP = model view projection [matrix]
+
+void main()
+{
+  gl_Position = u_MVP * position;
+  v_TexCoord = texCoord;
+  v_Layer = layer;
+};
@@ -0,0 +1,19 @@
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+layout(std140) uniform Object
+{
+  mat4 u_Model;
+  vec4 u_Color;
+};
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+  vec4 texColor = texture(u_Texture, v_TexCoord);
+  color = texColor * u_Color;
+}
@@ -0,0 +1,27 @@
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+// Shared by every program, uploaded once per frame by Renderer::SetFrameData
+layout(std140) uniform Frame
+{
+  mat4 u_Projection;
+  mat4 u_View;
+  float u_Time;
+};
+
+// Bound per draw with glBindBufferRange
+layout(std140) uniform Object
+{
+  mat4 u_Model;
+  vec4 u_Color;
+};
+
+void main()
+{
+  gl_Position = u_Projection * u_View * u_Model * position;
+  v_TexCoord = texCoord;
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in float texIndex;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+  gl_Position = u_ViewProjection * vec4(position, 1.0);
+  v_Color = color;
+  v_TexCoord = texCoord;
+  v_TexIndex = int(texIndex);
+}
@@ -0,0 +1,15 @@
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in mat4 model; // per instance, occupies locations 2-5
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+  gl_Position = u_ViewProjection * model * position;
+  v_TexCoord = texCoord;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -11,19 +12,39 @@
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
 #include "Debug.h"
+#include "FrameTimer.h"
+#include "GLState.h"
+#include "GpuProfiler.h"
 #include "IndexBuffer.h"
 #include "VertexBuffer.h"
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Renderer.h"
+#include "RenderStats.h"
+#include "SimulationThread.h"
 #include "Texture.h"
 
-#include "tests/TestClearColor.h"
-#include "tests/TestMultipleViewports.h"
+#include "tools/Tools.h"
 
-int main(void)
+#include "tests/TestRegistry.h"
+
+int main(int argc, char** argv)
 {
+	int exitCode;
+	if (RunTool(argc, argv, exitCode))
+		return exitCode;
+
+	CpuProfiler::SetThreadName("Main");
+
+	// Read assets from the packed archive when there is one (see `OpenGL.exe pack-assets`),
+	// from the loose files under res/ otherwise
+	AssetArchive assets;
+	if (assets.Open("assets.pak"))
+		AssetArchive::Mount(&assets);
+
 	GLFWwindow* window;
 
 	/* Initialize the library */
@@ -65,6 +86,8 @@ int main(void)
 
 	std::cout << glGetString(GL_VERSION) << std::endl;
 
+	Shader::EnableParallelCompile();
+
 	// Set debug callback
 	if (glDebugMessageCallback != NULL) {
 		glDebugMessageCallback(glDebugCallback, NULL);
@@ -72,9 +95,17 @@ int main(void)
 	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); // so the debugbreak has the call stack
 	glEnable(GL_DEBUG_OUTPUT);
 
+	// Route binds for this context through a state cache
+	GLState glState;
+	GLState::MakeCurrent(&glState);
+
 	// enable transparency blending
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glState.SetBlend(true);
+	glState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// GPU timings of the frame, read back a few frames late
+	GpuProfiler gpuProfiler;
+	GpuProfiler::MakeCurrent(&gpuProfiler);
 
 	Renderer renderer;
 
@@ -90,65 +121,153 @@ int main(void)
 		test::Test* test;
 	};
 
-	TestCase* tests[] = {
-		new TestCase{ "Multiple Viewports", new test::TestMultipleViewports() },
-		new TestCase{ "Clear Color",        new test::TestClearColor() },
-	};
+	size_t testCount;
+	const test::TestRegistration* registrations = test::GetTests(testCount);
+	std::vector<TestCase*> tests;
+	for (size_t i = 0; i < testCount; i++)
+		tests.push_back(new TestCase{ registrations[i].Name, registrations[i].Create() });
 
 	static const char* selectedLabel = NULL;
 	TestCase *currentTest = NULL;
 
+	// Bind counters of the previous frame, shown in the test selector
+	GLState::Counters bindCounters[GLState::BindingCount] = {};
+
+	// Tests update at a fixed 60 Hz whatever the frame rate, so vsync can be turned off
+	FrameTimer frameTimer;
+	bool vsync = true;
+
+	// Tests that build frame packets can update on their own thread instead
+	SimulationThread simulation;
+	bool simulate = false;
+
 	/* Loop until the user closes the window */
 	while (!glfwWindowShouldClose(window))
 	{
+		CpuProfiler::NewFrame();
+		PROFILE_SCOPE("Frame");
+
+		unsigned int updates = frameTimer.Advance();
+
 		/* Render here */
+		glState.ResetCounters();
+		gpuProfiler.BeginFrame();
 		renderer.Clear();
 
 		if (currentTest) {
-			currentTest->test->OnUpdate(0.0f);
-			currentTest->test->OnRender(renderer, windowX, windowY);
+			if (!simulation.IsRunning())
+			{
+				PROFILE_SCOPE("Update");
+				for (unsigned int i = 0; i < updates; i++)
+					currentTest->test->OnUpdate(frameTimer.GetStep());
+			}
+			renderer.SetInterpolation(frameTimer.GetAlpha());
+			PROFILE_SCOPE("Render");
+			GpuScope scope(currentTest->label);
+			if (!simulation.IsRunning())
+				currentTest->test->OnRender(renderer, windowX, windowY);
+			else if (const FramePacket* packet = simulation.AcquireFrame())
+				currentTest->test->OnRenderFrame(renderer, *packet);
 		}
 
-		// Start the ImGui frame
-		ImGui_ImplOpenGL3_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
-		ImGui::NewFrame();
-
-        ImGui::Begin("Test Selector");                     
-		if (ImGui::BeginCombo("Test name", selectedLabel)) 
 		{
-			for (int i = 0; i < IM_ARRAYSIZE(tests); i++) 
+			PROFILE_SCOPE("ImGui Build");
+			// Start the ImGui frame
+			ImGui_ImplOpenGL3_NewFrame();
+			ImGui_ImplGlfw_NewFrame();
+			ImGui::NewFrame();
+
+			ImGui::Begin("Test Selector");                     
+			if (ImGui::BeginCombo("Test name", selectedLabel)) 
 			{
-				bool isSelected = selectedLabel == tests[i]->label;
-				if (ImGui::Selectable(tests[i]->label, isSelected)) 
+				for (size_t i = 0; i < tests.size(); i++) 
 				{
-					currentTest = tests[i];
-					selectedLabel = currentTest->label;
-				};
+					bool isSelected = selectedLabel == tests[i]->label;
+					if (ImGui::Selectable(tests[i]->label, isSelected)) 
+					{
+						simulation.Stop();
+						currentTest = tests[i];
+						selectedLabel = currentTest->label;
+						if (simulate && currentTest->test->HasFramePackets())
+							simulation.Start(currentTest->test, windowX, windowY);
+					};
+				}
+				ImGui::EndCombo();
 			}
-			ImGui::EndCombo();
-		}
-		ImGui::End();
+			if (ImGui::Checkbox("VSync", &vsync))
+				glfwSwapInterval(vsync ? 1 : 0);
+			ImGui::SameLine();
+			ImGui::Text("%.2f ms, %u updates, alpha %.2f, %llu dropped", frameTimer.GetFrameTime() * 1000.0,
+				updates, frameTimer.GetAlpha(), frameTimer.GetDroppedSteps());
+			if (ImGui::Checkbox("Simulation thread", &simulate))
+			{
+				simulation.Stop();
+				if (simulate && currentTest && currentTest->test->HasFramePackets())
+					simulation.Start(currentTest->test, windowX, windowY);
+			}
+			ImGui::SameLine();
+			if (simulation.IsRunning())
+				ImGui::Text("%u updates/s", simulation.GetUpdatesPerSecond());
+			else if (simulate)
+				ImGui::Text("not supported by this test");
+			if (ImGui::CollapsingHeader("GL binds (issued / skipped)"))
+			{
+				for (int i = 0; i < GLState::BindingCount; i++)
+				{
+					GLState::Binding binding = (GLState::Binding)i;
+					ImGui::Text("%-16s %6u / %6u", GLState::GetBindingName(binding), bindCounters[i].Issued, bindCounters[i].Skipped);
+				}
+			}
+			ImGui::End();
 
-		if (currentTest) {
-			currentTest->test->OnImGuiRender(windowX, windowY);
+			if (currentTest) {
+				// Settings are shared with the simulation thread
+				std::lock_guard<std::mutex> lock(simulation.GetTestMutex());
+				currentTest->test->OnImGuiRender(windowX, windowY);
+			}
+
+			gpuProfiler.OnImGuiRender();
+			CpuProfiler::OnImGuiRender();
+			RenderStats::Get().OnImGuiRender();
 		}
 
-        ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		// Snapshot before ImGui draws, its GL calls bypass the state cache
+		for (int i = 0; i < GLState::BindingCount; i++)
+			bindCounters[i] = glState.GetCounters((GLState::Binding)i);
+		RenderStats::Get().EndFrame();
+
+		{
+			PROFILE_SCOPE("ImGui Render");
+			GpuScope scope("ImGui");
+			ImGui::Render();
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		}
+		glState.Invalidate();
+		gpuProfiler.EndFrame();
 
 		/* Swap front and back buffers */
-		glfwSwapBuffers(window);
+		{
+			PROFILE_SCOPE("SwapBuffers");
+			glfwSwapBuffers(window);
+		}
 
 		/* Poll for and process events */
-		glfwPollEvents();
+		{
+			PROFILE_SCOPE("PollEvents");
+			glfwPollEvents();
+		}
 	}
 
+	simulation.Stop();
+
 	// ImgGui Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 
+	GpuProfiler::MakeCurrent(nullptr);
+	GLState::MakeCurrent(nullptr);
+
 	glfwTerminate();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "AssetArchive.h"
+
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Lz4.h"
+
+static_assert(sizeof(AssetArchive::Header) == 16, "archive header layout changed");
+static_assert(sizeof(AssetArchive::Entry) == 32, "archive entry layout changed");
+
+AssetArchive* AssetArchive::s_Mounted = nullptr;
+
+AssetArchive::AssetArchive()
+	: m_Data(nullptr),
+	  m_Size(0),
+	  m_FileHandle(nullptr),
+	  m_MappingHandle(nullptr)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+	if (s_Mounted == this)
+		s_Mounted = nullptr;
+	Close();
+}
+
+bool AssetArchive::Open(const std::string& path)
+{
+	Close();
+
+	if (!Map(path))
+		return false;
+
+	const Header* header = (const Header*)m_Data;
+	bool valid = m_Size >= sizeof(Header) && header->Magic == Magic && header->Version == Version
+		&& m_Size >= sizeof(Header) + (uint64_t)header->EntryCount * sizeof(Entry);
+
+	if (valid)
+	{
+		const Entry* entries = (const Entry*)(m_Data + sizeof(Header));
+		const char* names = (const char*)(entries + header->EntryCount);
+		size_t namesSize = m_Size - ((const unsigned char*)names - m_Data);
+
+		for (uint32_t i = 0; i < header->EntryCount && valid; i++)
+		{
+			const Entry& entry = entries[i];
+			valid = (uint64_t)entry.NameOffset + entry.NameLength <= namesSize
+				&& entry.Offset <= m_Size && entry.StoredSize <= m_Size - entry.Offset
+				&& ((entry.Flags & Lz4Compressed) || entry.StoredSize == entry.Size);
+
+			if (valid)
+				m_Entries[std::string(names + entry.NameOffset, entry.NameLength)] = &entry;
+		}
+	}
+
+	if (!valid)
+	{
+		std::cout << "Warning: '" << path << "' is not a valid asset archive" << std::endl;
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void AssetArchive::Close()
+{
+	m_Entries.clear();
+	Unmap();
+}
+
+AssetView AssetArchive::Find(const std::string& name) const
+{
+	auto it = m_Entries.find(name);
+	if (it == m_Entries.end())
+		return AssetView();
+
+	const Entry& entry = *it->second;
+	const unsigned char* stored = m_Data + entry.Offset;
+
+	if (!(entry.Flags & Lz4Compressed))
+		return AssetView(stored, entry.Size);
+
+	std::vector<unsigned char> data(entry.Size);
+	if (!Lz4Decompress(stored, entry.StoredSize, data.data(), data.size()))
+	{
+		std::cout << "Warning: asset '" << name << "' is corrupt" << std::endl;
+		return AssetView();
+	}
+	return AssetView(std::move(data));
+}
+
+void AssetArchive::Mount(AssetArchive* archive)
+{
+	s_Mounted = archive;
+}
+
+AssetView AssetArchive::Read(const std::string& path)
+{
+	if (s_Mounted)
+	{
+		AssetView view = s_Mounted->Find(path);
+		if (view.IsValid())
+			return view;
+	}
+
+	// Not packed (or no archive during development), one read for the whole file
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return AssetView();
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<unsigned char> data(size > 0 ? size : 0);
+	size_t read = data.empty() ? 0 : fread(data.data(), 1, data.size(), file);
+	fclose(file);
+
+	if (read != data.size())
+		return AssetView();
+	return AssetView(std::move(data));
+}
+
+#ifdef _WIN32
+bool AssetArchive::Map(const std::string& path)
+{
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	m_Data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	m_Size = (size_t)size.QuadPart;
+	m_FileHandle = file;
+	m_MappingHandle = mapping;
+
+	if (!m_Data)
+	{
+		Unmap();
+		return false;
+	}
+	return true;
+}
+
+void AssetArchive::Unmap()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_MappingHandle)
+		CloseHandle((HANDLE)m_MappingHandle);
+	if (m_FileHandle)
+		CloseHandle((HANDLE)m_FileHandle);
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_FileHandle = nullptr;
+	m_MappingHandle = nullptr;
+}
+#else
+bool AssetArchive::Map(const std::string& path)
+{
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	void* data = MAP_FAILED;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+		data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// The mapping keeps the file alive by itself
+	close(file);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	m_Data = (const unsigned char*)data;
+	m_Size = (size_t)info.st_size;
+	return true;
+}
+
+void AssetArchive::Unmap()
+{
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
+#endif
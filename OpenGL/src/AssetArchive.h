@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The bytes of one asset. Usually a view straight into the memory mapped archive,
+ * for compressed entries and loose files it owns a buffer instead. Move only, so the
+ * pointer never outlives the buffer it points into.
+ */
+class AssetView
+{
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+	std::vector<unsigned char> m_Storage;
+	// Not m_Data != nullptr, data() of an empty vector may be null
+	bool m_Valid;
+public:
+	AssetView() : m_Data(nullptr), m_Size(0), m_Valid(false) {}
+	AssetView(const unsigned char* data, size_t size) : m_Data(data), m_Size(size), m_Valid(true) {}
+	explicit AssetView(std::vector<unsigned char>&& storage)
+		: m_Data(storage.data()), m_Size(storage.size()), m_Storage(std::move(storage)), m_Valid(true) {}
+
+	AssetView(AssetView&&) = default;
+	AssetView& operator=(AssetView&&) = default;
+	AssetView(const AssetView&) = delete;
+	AssetView& operator=(const AssetView&) = delete;
+
+	inline const unsigned char* GetData() const { return m_Data; }
+	inline size_t GetSize() const { return m_Size; }
+	// False if the asset doesn't exist (an empty file is still valid)
+	inline bool IsValid() const { return m_Valid; }
+};
+
+/**
+ * A single packed file holding many assets, read through a memory mapping.
+ *
+ * Layout: a Header, EntryCount Entry records, the entry names back to back, then each
+ * entry's bytes starting on an Alignment boundary. Entries are optionally LZ4 block
+ * compressed. Names are the paths the code already uses ("res/shaders/Basic.vert"),
+ * so once an archive is mounted AssetArchive::Read() finds them there instead of on
+ * disk. Build one with `OpenGL.exe pack-assets`.
+ */
+class AssetArchive
+{
+public:
+	static const uint32_t Magic = 0x4b504c47; // "GLPK"
+	static const uint32_t Version = 1;
+
+	enum EntryFlags : uint32_t
+	{
+		Lz4Compressed = 1 << 0,
+	};
+
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Alignment;
+	};
+
+	struct Entry
+	{
+		uint64_t Offset;     // from the start of the archive
+		uint32_t StoredSize; // in the archive
+		uint32_t Size;       // once decompressed
+		uint32_t NameOffset; // from the start of the names
+		uint32_t NameLength;
+		uint32_t Flags;
+		uint32_t Reserved;
+	};
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+	void* m_FileHandle;    // Windows only
+	void* m_MappingHandle; // Windows only
+	std::unordered_map<std::string, const Entry*> m_Entries;
+
+	static AssetArchive* s_Mounted;
+public:
+	AssetArchive();
+	~AssetArchive();
+
+	// Maps the archive and checks its table of contents, returns false (with a
+	// warning) if it is missing or malformed
+	bool Open(const std::string& path);
+	void Close();
+
+	// Returns an invalid view if there is no such entry or it fails to decompress
+	AssetView Find(const std::string& name) const;
+	inline size_t GetEntryCount() const { return m_Entries.size(); }
+
+	// The archive Read() looks in before the file system, null for loose files only.
+	// The archive has to outlive the mount
+	static void Mount(AssetArchive* archive);
+	static inline AssetArchive* GetMounted() { return s_Mounted; }
+
+	// Reads path from the mounted archive, or from disk in one go if it isn't packed
+	static AssetView Read(const std::string& path);
+private:
+	bool Map(const std::string& path);
+	void Unmap();
+};
@@ -0,0 +1,165 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr UniformId u_Textures("u_Textures");
+static constexpr UniformId u_ViewProjection("u_ViewProjection");
+
+static const glm::vec4 s_QuadPositions[4] = {
+	{ -0.5f, -0.5f, 0.0f, 1.0f }, // 0 -- bottom left
+	{  0.5f, -0.5f, 0.0f, 1.0f }, // 1 -- bottom right
+	{  0.5f,  0.5f, 0.0f, 1.0f }, // 2 -- top right
+	{ -0.5f,  0.5f, 0.0f, 1.0f }  // 3 -- top left
+};
+
+static const unsigned int s_White = 0xffffffff;
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads /*= 10000*/)
+	: m_MaxQuads(maxQuads),
+	  m_TextureSlotCount(MaxTextureSlots),
+	  m_Vertices(maxQuads * 4),
+	  m_QuadCount(0),
+	  m_TextureSlotIndex(1),
+	  m_VertexBuffer(BatchesPerRegion * maxQuads * 4 * sizeof(BatchVertex)),
+	  m_IndexBuffer(GenerateQuadIndices(maxQuads).data(), maxQuads * 6),
+	  m_Shader("Batch"),
+	  m_WhiteTexture(1, 1, &s_White),
+	  m_Renderer(nullptr),
+	  m_Stats{ 0, 0 }
+{
+	m_Layout.Push<float>(3); // position
+	m_Layout.Push<float>(4); // color
+	m_Layout.Push<float>(2); // texture coordinates
+	m_Layout.Push<float>(1); // texture slot
+	m_VertexArray.AddBuffer(m_VertexBuffer, m_Layout);
+
+	int maxTextureUnits;
+	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+	m_TextureSlotCount = std::min((unsigned int)maxTextureUnits, MaxTextureSlots);
+
+	int samplers[MaxTextureSlots];
+	for (unsigned int i = 0; i < MaxTextureSlots; i++)
+		samplers[i] = i;
+
+	m_Shader.Bind();
+	m_Shader.SetUniform1iv(u_Textures, MaxTextureSlots, samplers);
+
+	m_TextureSlots.fill(nullptr);
+	m_TextureSlots[0] = &m_WhiteTexture;
+
+	m_VertexArray.Unbind();
+	m_IndexBuffer.Unbind();
+	m_Shader.Unbind();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+void BatchRenderer::BeginBatch(const Renderer& renderer, const glm::mat4& viewProjection)
+{
+	m_Renderer = &renderer;
+	m_Stats = { 0, 0 };
+
+	m_Shader.Bind();
+	m_Shader.SetUniformMatrix4f(u_ViewProjection, viewProjection);
+
+	m_QuadCount = 0;
+	m_TextureSlotIndex = 1;
+}
+
+void BatchRenderer::SubmitQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec4& uv, const Texture* texture)
+{
+	if (m_QuadCount >= m_MaxQuads)
+		Flush();
+
+	float texIndex = FindOrAddTextureSlot(texture);
+
+	const glm::vec2 texCoords[4] = {
+		{ uv.x, uv.y },
+		{ uv.z, uv.y },
+		{ uv.z, uv.w },
+		{ uv.x, uv.w }
+	};
+
+	BatchVertex* vertex = &m_Vertices[m_QuadCount * 4];
+	for (unsigned int i = 0; i < 4; i++, vertex++)
+	{
+		vertex->Position = glm::vec3(transform * s_QuadPositions[i]);
+		vertex->Color = color;
+		vertex->TexCoord = texCoords[i];
+		vertex->TexIndex = texIndex;
+	}
+
+	m_QuadCount++;
+	m_Stats.QuadCount++;
+}
+
+void BatchRenderer::EndBatch()
+{
+	Flush();
+	m_VertexBuffer.EndFrame();
+	m_Renderer = nullptr;
+}
+
+void BatchRenderer::Flush()
+{
+	if (m_QuadCount == 0)
+		return;
+
+	unsigned int size = m_QuadCount * 4 * sizeof(BatchVertex);
+	StreamingVertexBuffer::Allocation allocation = m_VertexBuffer.Allocate(size, sizeof(BatchVertex));
+	memcpy(allocation.CpuPtr, m_Vertices.data(), size);
+	m_VertexBuffer.Commit(allocation, size);
+
+	for (unsigned int i = 0; i < m_TextureSlotIndex; i++)
+		m_TextureSlots[i]->Bind(i);
+
+	int baseVertex = allocation.GpuOffset / sizeof(BatchVertex);
+	m_Renderer->Draw(m_VertexArray, m_IndexBuffer, m_Shader, m_QuadCount * 6, baseVertex);
+	m_Stats.DrawCalls++;
+
+	m_QuadCount = 0;
+	m_TextureSlotIndex = 1;
+}
+
+float BatchRenderer::FindOrAddTextureSlot(const Texture* texture)
+{
+	if (!texture)
+		return 0.0f;
+
+	for (unsigned int i = 1; i < m_TextureSlotIndex; i++)
+	{
+		if (m_TextureSlots[i] == texture)
+			return (float)i;
+	}
+
+	// Out of texture units, draw what we have and start over
+	if (m_TextureSlotIndex >= m_TextureSlotCount)
+		Flush();
+
+	m_TextureSlots[m_TextureSlotIndex] = texture;
+	return (float)m_TextureSlotIndex++;
+}
+
+std::vector<unsigned int> BatchRenderer::GenerateQuadIndices(unsigned int maxQuads)
+{
+	std::vector<unsigned int> indices(maxQuads * 6);
+
+	unsigned int offset = 0;
+	for (unsigned int i = 0; i < indices.size(); i += 6)
+	{
+		indices[i + 0] = offset + 0;
+		indices[i + 1] = offset + 1;
+		indices[i + 2] = offset + 2;
+
+		indices[i + 3] = offset + 2;
+		indices[i + 4] = offset + 3;
+		indices[i + 5] = offset + 0;
+
+		offset += 4;
+	}
+
+	return indices;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "StreamingVertexBuffer.h"
+#include "Texture.h"
+
+struct BatchVertex
+{
+	glm::vec3 Position;
+	glm::vec4 Color;
+	glm::vec2 TexCoord;
+	float TexIndex;
+};
+
+/**
+ * Collects textured quads into a CPU staging array and draws them with a single
+ * glDrawElements per batch. A batch is flushed early when it runs out of quads or
+ * texture slots.
+ *
+ * Usage (once per frame):
+ *   batch.BeginBatch(renderer, proj * view);
+ *   batch.SubmitQuad(transform, color, uv, &texture); // ...many times
+ *   batch.EndBatch();
+ */
+class BatchRenderer
+{
+public:
+	// Must match the size of u_Textures in res/shaders/Batch.frag
+	static const unsigned int MaxTextureSlots = 16;
+	// Full batches that fit in one streaming buffer region before it has to move on
+	static const unsigned int BatchesPerRegion = 2;
+
+	struct Stats
+	{
+		unsigned int DrawCalls;
+		unsigned int QuadCount;
+	};
+private:
+	unsigned int m_MaxQuads;
+	unsigned int m_TextureSlotCount;
+
+	std::vector<BatchVertex> m_Vertices; // CPU staging array, m_MaxQuads * 4 vertices
+	unsigned int m_QuadCount;
+
+	std::array<const Texture*, MaxTextureSlots> m_TextureSlots;
+	unsigned int m_TextureSlotIndex; // next free slot (slot 0 is always the white texture)
+
+	VertexArray m_VertexArray;
+	StreamingVertexBuffer m_VertexBuffer;
+	VertexBufferLayout m_Layout;
+	IndexBuffer m_IndexBuffer;
+	Shader m_Shader;
+	Texture m_WhiteTexture;
+
+	const Renderer* m_Renderer;
+	Stats m_Stats;
+public:
+	BatchRenderer(unsigned int maxQuads = 10000);
+	~BatchRenderer();
+
+	void BeginBatch(const Renderer& renderer, const glm::mat4& viewProjection);
+	// transform maps the unit quad (-0.5..0.5) into world space, uv is (u0, v0, u1, v1)
+	void SubmitQuad(const glm::mat4& transform, const glm::vec4& color,
+		const glm::vec4& uv = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), const Texture* texture = nullptr);
+	void EndBatch();
+	// Uploads the staged vertices and issues one draw call for them
+	void Flush();
+
+	inline const Stats& GetStats() const { return m_Stats; }
+
+	// Two triangles (0 1 2, 2 3 0) for each group of four vertices
+	static std::vector<unsigned int> GenerateQuadIndices(unsigned int maxQuads);
+private:
+	float FindOrAddTextureSlot(const Texture* texture);
+};
@@ -0,0 +1,283 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+#include <GL/glew.h>
+
+#include "GLState.h"
+#include "GpuProfiler.h"
+#include "HeadlessContext.h"
+#include "Renderer.h"
+#include "Shader.h"
+
+namespace {
+	// Frames the CPU may run ahead of the GPU, like a swap chain would allow
+	const int MaxFramesInFlight = 2;
+
+	// Column names for the counters in the JSON and CSV output
+	const char* const s_CounterKeys[RenderStats::CounterCount] = {
+		"draw_calls",
+		"indices",
+		"instances",
+		"program_binds",
+		"vertex_array_binds",
+		"texture_binds",
+		"uniform_updates",
+		"buffer_bytes",
+		"texture_bytes",
+		"visible",
+		"culled",
+	};
+
+	double Milliseconds(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	void WriteJsonString(FILE* file, const std::string& text)
+	{
+		fputc('"', file);
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				fputc('\\', file);
+			if ((unsigned char)c >= 0x20)
+				fputc(c, file);
+		}
+		fputc('"', file);
+	}
+
+	void WriteJsonDistribution(FILE* file, const char* name, const std::vector<double>& samples)
+	{
+		BenchmarkDistribution d = BenchmarkDistribution::FromSamples(samples);
+		fprintf(file, "\"%s\": { \"mean\": %.4f, \"min\": %.4f, \"max\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"samples\": %zu }",
+			name, d.Mean, d.Min, d.Max, d.P50, d.P95, d.P99, d.Samples);
+	}
+
+	void WriteCsvDistribution(FILE* file, const std::vector<double>& samples)
+	{
+		BenchmarkDistribution d = BenchmarkDistribution::FromSamples(samples);
+		fprintf(file, ",%.4f,%.4f,%.4f,%.4f,%.4f,%.4f", d.Mean, d.Min, d.Max, d.P50, d.P95, d.P99);
+	}
+}
+
+BenchmarkDistribution BenchmarkDistribution::FromSamples(std::vector<double> samples)
+{
+	BenchmarkDistribution d = {};
+	d.Samples = samples.size();
+	if (samples.empty())
+		return d;
+
+	std::sort(samples.begin(), samples.end());
+	for (double sample : samples)
+		d.Mean += sample;
+	d.Mean /= samples.size();
+	d.Min = samples.front();
+	d.Max = samples.back();
+
+	// Nearest rank: the smallest sample with at least p percent of the samples at or below it
+	auto percentile = [&samples](double p) {
+		size_t rank = (size_t)std::ceil(p / 100.0 * samples.size());
+		return samples[std::max<size_t>(rank, 1) - 1];
+	};
+	d.P50 = percentile(50.0);
+	d.P95 = percentile(95.0);
+	d.P99 = percentile(99.0);
+	return d;
+}
+
+bool RunBenchmark(const test::TestRegistration& registration, const BenchmarkSettings& settings, BenchmarkResult& result)
+{
+	result = BenchmarkResult();
+	result.Test = registration.Name;
+
+	HeadlessContext context;
+	if (!context.Create(settings.Width, settings.Height, settings.AllowEgl))
+		return false;
+
+	result.Renderer = std::string((const char*)glGetString(GL_RENDERER)) + ", " + (const char*)glGetString(GL_VERSION);
+
+	Shader::EnableParallelCompile();
+
+	GLState glState;
+	GLState::MakeCurrent(&glState);
+	glState.SetBlend(true);
+	glState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	RenderStats& stats = RenderStats::Get();
+	double counterTotals[RenderStats::CounterCount] = {};
+	{
+		// Whole frames only, a query pair around every draw would cost CPU time of its own
+		GpuProfiler gpuProfiler;
+		gpuProfiler.SetMaxDepth(0);
+		gpuProfiler.SetEnabled(settings.MeasureGpu);
+		GpuProfiler::MakeCurrent(&gpuProfiler);
+
+		Renderer renderer;
+		std::unique_ptr<test::Test> test(registration.Create());
+		GLsync fences[MaxFramesInFlight] = {};
+
+		// A fixed step keeps every run doing the same work
+		const float deltaTime = 1.0f / 60.0f;
+		for (int frame = 0; frame < settings.Warmup + settings.Frames; frame++)
+		{
+			bool measured = frame >= settings.Warmup;
+			if (frame == settings.Warmup)
+			{
+				// Drain the warmup frames first so none of them end up in the samples
+				glFinish();
+				gpuProfiler.Resolve();
+				gpuProfiler.SetFrameTimeSink(&result.GpuMs);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			glState.ResetCounters();
+			gpuProfiler.BeginFrame();
+			context.BindFramebuffer();
+			renderer.Clear();
+			test->OnUpdate(deltaTime);
+			test->OnRender(renderer, settings.Width, settings.Height);
+			gpuProfiler.EndFrame();
+			stats.EndFrame();
+
+			auto submitted = std::chrono::steady_clock::now();
+
+			// Nothing presents, so wait for the frame before last instead of letting the queue grow
+			GLsync& fence = fences[frame % MaxFramesInFlight];
+			if (fence)
+			{
+				glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+				glDeleteSync(fence);
+			}
+			fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+			auto end = std::chrono::steady_clock::now();
+			if (measured)
+			{
+				result.SubmitMs.push_back(Milliseconds(submitted - start));
+				result.FrameMs.push_back(Milliseconds(end - start));
+				for (int i = 0; i < RenderStats::CounterCount; i++)
+					counterTotals[i] += stats.GetSummary((RenderStats::Counter)i).Last;
+			}
+		}
+
+		// Collect the frames still in flight
+		glFinish();
+		gpuProfiler.Resolve();
+		gpuProfiler.SetFrameTimeSink(nullptr);
+		GpuProfiler::MakeCurrent(nullptr);
+
+		for (GLsync fence : fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+
+		if (settings.Hash)
+			result.Hash = context.HashPixels();
+	}
+
+	for (int i = 0; i < RenderStats::CounterCount; i++)
+		result.Counters[i] = counterTotals[i] / settings.Frames;
+
+	GLState::MakeCurrent(nullptr);
+	return true;
+}
+
+bool WriteBenchmarkJson(const std::string& path, const std::string& label, const BenchmarkSettings& settings,
+	const std::vector<BenchmarkResult>& results)
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::cout << "Warning: could not open '" << path << "' for writing" << std::endl;
+		return false;
+	}
+
+	fprintf(file, "{\n  \"label\": ");
+	WriteJsonString(file, label);
+	fprintf(file, ",\n  \"renderer\": ");
+	WriteJsonString(file, results.empty() ? "" : results[0].Renderer);
+	fprintf(file, ",\n  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n  \"warmup\": %d,\n  \"tests\": [",
+		settings.Width, settings.Height, settings.Frames, settings.Warmup);
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		fprintf(file, "%s\n    {\n      \"name\": ", i ? "," : "");
+		WriteJsonString(file, result.Test);
+		fprintf(file, ",\n      ");
+		WriteJsonDistribution(file, "frame_ms", result.FrameMs);
+		fprintf(file, ",\n      ");
+		WriteJsonDistribution(file, "submit_ms", result.SubmitMs);
+		fprintf(file, ",\n      ");
+		WriteJsonDistribution(file, "gpu_ms", result.GpuMs);
+		fprintf(file, ",\n      \"counters\": {");
+		for (int c = 0; c < RenderStats::CounterCount; c++)
+			fprintf(file, "%s \"%s\": %.2f", c ? "," : "", s_CounterKeys[c], result.Counters[c]);
+		fprintf(file, " }");
+		if (settings.Hash)
+			fprintf(file, ",\n      \"hash\": \"%016llx\"", (unsigned long long)result.Hash);
+		fprintf(file, "\n    }");
+	}
+	fprintf(file, "\n  ]\n}\n");
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+bool WriteBenchmarkCsv(const std::string& path, const std::string& label, const std::vector<BenchmarkResult>& results)
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::cout << "Warning: could not open '" << path << "' for writing" << std::endl;
+		return false;
+	}
+
+	fprintf(file, "label,test");
+	for (const char* series : { "frame_ms", "submit_ms", "gpu_ms" })
+	{
+		for (const char* stat : { "mean", "min", "max", "p50", "p95", "p99" })
+			fprintf(file, ",%s_%s", series, stat);
+	}
+	for (const char* key : s_CounterKeys)
+		fprintf(file, ",%s", key);
+	fprintf(file, "\n");
+
+	// Names and labels are quoted, a doubled quote stands for one
+	auto writeQuoted = [file](const std::string& text) {
+		fputc('"', file);
+		for (char c : text)
+		{
+			if (c == '"')
+				fputc('"', file);
+			fputc(c, file);
+		}
+		fputc('"', file);
+	};
+
+	for (const BenchmarkResult& result : results)
+	{
+		writeQuoted(label);
+		fputc(',', file);
+		writeQuoted(result.Test);
+		WriteCsvDistribution(file, result.FrameMs);
+		WriteCsvDistribution(file, result.SubmitMs);
+		WriteCsvDistribution(file, result.GpuMs);
+		for (double counter : result.Counters)
+			fprintf(file, ",%.2f", counter);
+		fprintf(file, "\n");
+	}
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RenderStats.h"
+#include "tests/TestRegistry.h"
+
+struct BenchmarkSettings
+{
+	int Frames = 300;
+	int Warmup = 30;
+	int Width = 960;
+	int Height = 540;
+	bool AllowEgl = true;
+	bool MeasureGpu = true;
+	bool Hash = false;
+};
+
+// Mean, extremes and nearest rank percentiles of a series of samples
+struct BenchmarkDistribution
+{
+	double Mean, Min, Max;
+	double P50, P95, P99;
+	size_t Samples;
+
+	static BenchmarkDistribution FromSamples(std::vector<double> samples);
+};
+
+struct BenchmarkResult
+{
+	std::string Test;
+	std::string Renderer; // GL_RENDERER and GL_VERSION
+	std::vector<double> FrameMs;  // CPU time of the whole frame, including the wait on the GPU
+	std::vector<double> SubmitMs; // CPU time spent issuing the frame
+	std::vector<double> GpuMs;    // timer queries, fewer samples if some came back too late
+	double Counters[RenderStats::CounterCount]; // per frame averages
+	uint64_t Hash;
+};
+
+/**
+ * Runs one test scene in its own headless context (see HeadlessContext) for
+ * settings.Warmup + settings.Frames frames with a fixed 1/60 s step and records the
+ * measured frames. Returns false if no context could be created.
+ */
+bool RunBenchmark(const test::TestRegistration& test, const BenchmarkSettings& settings, BenchmarkResult& result);
+
+// One object per test with the distribution of every series and the counters
+bool WriteBenchmarkJson(const std::string& path, const std::string& label, const BenchmarkSettings& settings,
+	const std::vector<BenchmarkResult>& results);
+// One row per test, same numbers as the JSON
+bool WriteBenchmarkCsv(const std::string& path, const std::string& label, const std::vector<BenchmarkResult>& results);
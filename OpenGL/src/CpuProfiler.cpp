@@ -0,0 +1,222 @@
+#include "CpuProfiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+namespace {
+	struct ThreadBuffer
+	{
+		unsigned int Id;
+		std::string Name; // guarded by Registry::Mutex
+		std::vector<CpuProfiler::Event> Events;
+		std::atomic<unsigned int> Count;
+		std::atomic<unsigned int> Generation; // capture the events belong to
+		std::atomic<unsigned int> Dropped;
+	};
+
+	// Buffers are never freed, so a thread that has exited still shows up in the trace
+	struct Registry
+	{
+		std::mutex Mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+		std::atomic<unsigned int> Generation{ 0 };
+		uint64_t CaptureStart = 0;
+
+		// Frame driven captures, main thread only
+		bool CaptureRequested = false;
+		int FramesLeft = 0;
+		std::string CapturePath;
+		std::string LastResult;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	thread_local ThreadBuffer* t_Buffer = nullptr;
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		if (!t_Buffer)
+		{
+			std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+			buffer->Events.resize(CpuProfiler::EventsPerThread);
+			buffer->Count = 0;
+			buffer->Generation = 0;
+			buffer->Dropped = 0;
+
+			Registry& registry = GetRegistry();
+			std::lock_guard<std::mutex> lock(registry.Mutex);
+			buffer->Id = (unsigned int)registry.Buffers.size();
+			buffer->Name = "Thread " + std::to_string(buffer->Id);
+			t_Buffer = buffer.get();
+			registry.Buffers.push_back(std::move(buffer));
+		}
+		return *t_Buffer;
+	}
+
+	void WriteJsonString(FILE* file, const char* text)
+	{
+		fputc('"', file);
+		for (; *text; text++)
+		{
+			if (*text == '"' || *text == '\\')
+				fputc('\\', file);
+			if ((unsigned char)*text >= 0x20)
+				fputc(*text, file);
+		}
+		fputc('"', file);
+	}
+}
+
+std::atomic<bool> CpuProfiler::s_Capturing{ false };
+
+uint64_t CpuProfiler::Now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(GetRegistry().Mutex);
+	buffer.Name = name;
+}
+
+void CpuProfiler::NewFrame()
+{
+	Registry& registry = GetRegistry();
+	if (registry.CaptureRequested)
+	{
+		registry.CaptureRequested = false;
+		BeginCapture();
+	}
+	else if (IsCapturing() && --registry.FramesLeft <= 0)
+	{
+		EndCapture();
+		registry.LastResult = WriteChromeTrace(registry.CapturePath)
+			? "Wrote " + registry.CapturePath
+			: "Failed to write " + registry.CapturePath;
+		std::cout << registry.LastResult << std::endl;
+	}
+}
+
+void CpuProfiler::RequestCapture(int frameCount, const std::string& path)
+{
+	Registry& registry = GetRegistry();
+	registry.CaptureRequested = true;
+	registry.FramesLeft = frameCount;
+	registry.CapturePath = path;
+}
+
+void CpuProfiler::BeginCapture()
+{
+	Registry& registry = GetRegistry();
+	registry.CaptureStart = Now();
+	// Every buffer from an older generation counts as empty, its thread resets it on the next event
+	registry.Generation.fetch_add(1, std::memory_order_release);
+	s_Capturing.store(true, std::memory_order_release);
+}
+
+void CpuProfiler::EndCapture()
+{
+	s_Capturing.store(false, std::memory_order_release);
+}
+
+void CpuProfiler::Record(const char* name, uint64_t start, uint64_t end)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	unsigned int generation = GetRegistry().Generation.load(std::memory_order_acquire);
+	if (buffer.Generation.load(std::memory_order_relaxed) != generation)
+	{
+		buffer.Count.store(0, std::memory_order_relaxed);
+		buffer.Dropped.store(0, std::memory_order_relaxed);
+		buffer.Generation.store(generation, std::memory_order_release);
+	}
+
+	unsigned int count = buffer.Count.load(std::memory_order_relaxed);
+	if (count == EventsPerThread)
+	{
+		buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.Events[count] = { name, start, end };
+	buffer.Count.store(count + 1, std::memory_order_release);
+}
+
+bool CpuProfiler::WriteChromeTrace(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::cout << "Warning: could not open '" << path << "' for writing" << std::endl;
+		return false;
+	}
+
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	unsigned int generation = registry.Generation.load(std::memory_order_acquire);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : registry.Buffers)
+	{
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->Id);
+		WriteJsonString(file, buffer->Name.c_str());
+		fprintf(file, "}}");
+		first = false;
+
+		if (buffer->Generation.load(std::memory_order_acquire) != generation)
+			continue;
+
+		unsigned int count = buffer->Count.load(std::memory_order_acquire);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const Event& event = buffer->Events[i];
+			// Complete events, timestamps in microseconds from the start of the capture
+			fprintf(file, ",\n{\"name\":");
+			WriteJsonString(file, event.Name);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->Id,
+				(event.Start - registry.CaptureStart) / 1000.0, (event.End - event.Start) / 1000.0);
+		}
+
+		unsigned int dropped = buffer->Dropped.load(std::memory_order_relaxed);
+		if (dropped)
+			std::cout << "Warning: " << buffer->Name << " dropped " << dropped << " events" << std::endl;
+	}
+	fprintf(file, "\n]}\n");
+
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+void CpuProfiler::OnImGuiRender()
+{
+	ImGui::Begin("CPU Profiler");
+#if PROFILE_CPU
+	static int frameCount = 60;
+	Registry& registry = GetRegistry();
+	ImGui::SliderInt("Frames", &frameCount, 1, 600);
+	if (IsCapturing() || registry.CaptureRequested)
+		ImGui::Text("Capturing, %d frames left", registry.FramesLeft);
+	else if (ImGui::Button("Capture cpu_trace.json"))
+		RequestCapture(frameCount, "cpu_trace.json");
+	if (!registry.LastResult.empty())
+		ImGui::Text("%s", registry.LastResult.c_str());
+#else
+	ImGui::Text("Zones are compiled out, build with PROFILE_CPU=1");
+#endif
+	ImGui::End();
+}
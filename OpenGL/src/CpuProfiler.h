@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Zones cost two clock reads while a capture runs and an atomic load otherwise. They are
+// compiled in for debug builds, build with PROFILE_CPU=1 to profile a release build
+#ifndef PROFILE_CPU
+#ifdef _DEBUG
+#define PROFILE_CPU 1
+#else
+#define PROFILE_CPU 0
+#endif
+#endif
+
+#if PROFILE_CPU
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// Times the rest of the enclosing block, name must be a string literal
+#define PROFILE_SCOPE(name) CpuZone PROFILE_CONCAT(cpuZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#endif
+
+/**
+ * Records CPU zones of every thread and writes them out as a Chrome trace
+ * (chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Each thread appends to its own fixed size buffer, so recording takes no lock: the
+ * owning thread is the only writer and publishes every event with a release store of
+ * the count. A capture spans whole frames, call NewFrame() at the top of the main loop.
+ */
+class CpuProfiler
+{
+public:
+	static const unsigned int EventsPerThread = 1 << 16;
+
+	struct Event
+	{
+		const char* Name;
+		uint64_t Start; // nanoseconds, see Now()
+		uint64_t End;
+	};
+private:
+	static std::atomic<bool> s_Capturing;
+public:
+	static inline bool IsCapturing() { return s_Capturing.load(std::memory_order_relaxed); }
+	static uint64_t Now();
+
+	// Shown as the thread's name in the trace
+	static void SetThreadName(const char* name);
+
+	// Starts or stops a requested capture on a frame boundary, writes the trace when done
+	static void NewFrame();
+	// Captures the next frameCount frames into path
+	static void RequestCapture(int frameCount, const std::string& path);
+
+	static void BeginCapture();
+	static void EndCapture();
+	// Writes the events of the last capture as trace_event JSON, false if the file can't be written
+	static bool WriteChromeTrace(const std::string& path);
+
+	// Called by CpuZone, drops the event if the thread's buffer is full
+	static void Record(const char* name, uint64_t start, uint64_t end);
+
+	static void OnImGuiRender();
+};
+
+class CpuZone
+{
+private:
+	const char* m_Name;
+	uint64_t m_Start; // 0 when no capture was running at the start
+public:
+	CpuZone(const char* name)
+		: m_Name(name), m_Start(CpuProfiler::IsCapturing() ? CpuProfiler::Now() : 0)
+	{
+	}
+
+	~CpuZone()
+	{
+		if (m_Start)
+			CpuProfiler::Record(m_Name, m_Start, CpuProfiler::Now());
+	}
+
+	CpuZone(const CpuZone&) = delete;
+	CpuZone& operator=(const CpuZone&) = delete;
+};
@@ -0,0 +1,184 @@
+#include "Culling.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CULLING_AVX 1
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define CULLING_SSE 1
+#endif
+
+BoundingBox BoundingBox::Transform(const glm::mat4& transform) const
+{
+	// Each axis of the matrix moves the new extents by |axis| times the old ones (Arvo)
+	glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+	glm::vec3 extents = GetExtents();
+	glm::vec3 newExtents =
+		glm::abs(glm::vec3(transform[0])) * extents.x +
+		glm::abs(glm::vec3(transform[1])) * extents.y +
+		glm::abs(glm::vec3(transform[2])) * extents.z;
+	return { center - newExtents, center + newExtents };
+}
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+{
+	// glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+	// A point is inside when -w <= x, y, z <= w in clip space
+	Frustum frustum;
+	frustum.Planes[Left]   = rows[3] + rows[0];
+	frustum.Planes[Right]  = rows[3] - rows[0];
+	frustum.Planes[Bottom] = rows[3] + rows[1];
+	frustum.Planes[Top]    = rows[3] - rows[1];
+	frustum.Planes[Near]   = rows[3] + rows[2];
+	frustum.Planes[Far]    = rows[3] - rows[2];
+
+	for (glm::vec4& plane : frustum.Planes)
+	{
+		float length = glm::length(glm::vec3(plane));
+		if (length > 0.0f)
+			plane /= length;
+	}
+	return frustum;
+}
+
+unsigned int CullingSet::Add(const BoundingBox& box)
+{
+	return Add(box.GetCenter(), box.GetExtents(), 0.0f);
+}
+
+unsigned int CullingSet::Add(const BoundingSphere& sphere)
+{
+	return Add(sphere.Center, glm::vec3(0.0f), sphere.Radius);
+}
+
+unsigned int CullingSet::Add(const glm::vec3& center, const glm::vec3& extents, float radius)
+{
+	m_CenterX.push_back(center.x);
+	m_CenterY.push_back(center.y);
+	m_CenterZ.push_back(center.z);
+	m_ExtentX.push_back(extents.x);
+	m_ExtentY.push_back(extents.y);
+	m_ExtentZ.push_back(extents.z);
+	m_Radius.push_back(radius);
+	return (unsigned int)m_CenterX.size() - 1;
+}
+
+void CullingSet::Clear()
+{
+	m_CenterX.clear();
+	m_CenterY.clear();
+	m_CenterZ.clear();
+	m_ExtentX.clear();
+	m_ExtentY.clear();
+	m_ExtentZ.clear();
+	m_Radius.clear();
+}
+
+unsigned int CullingSet::GetSimdWidth()
+{
+#if CULLING_AVX
+	return 8;
+#elif CULLING_SSE
+	return 4;
+#else
+	return 1;
+#endif
+}
+
+void CullingSet::Cull(const Frustum& frustum, std::vector<unsigned int>& visible) const
+{
+	visible.clear();
+	unsigned int count = GetCount();
+	unsigned int i = 0;
+
+#if CULLING_AVX
+	const __m256 zero = _mm256_setzero_ps();
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 cx = _mm256_loadu_ps(&m_CenterX[i]);
+		__m256 cy = _mm256_loadu_ps(&m_CenterY[i]);
+		__m256 cz = _mm256_loadu_ps(&m_CenterZ[i]);
+		__m256 ex = _mm256_loadu_ps(&m_ExtentX[i]);
+		__m256 ey = _mm256_loadu_ps(&m_ExtentY[i]);
+		__m256 ez = _mm256_loadu_ps(&m_ExtentZ[i]);
+		__m256 radius = _mm256_loadu_ps(&m_Radius[i]);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const glm::vec4& plane : frustum.Planes)
+		{
+			__m256 distance = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)), _mm256_mul_ps(cy, _mm256_set1_ps(plane.y))),
+				_mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+			__m256 reach = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(std::fabs(plane.x))), _mm256_mul_ps(ey, _mm256_set1_ps(std::fabs(plane.y)))),
+				_mm256_add_ps(_mm256_mul_ps(ez, _mm256_set1_ps(std::fabs(plane.z))), radius));
+			// distance + reach >= 0, the object reaches the inner side of the plane
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_GE_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(inside);
+		for (unsigned int lane = 0; lane < 8; lane++)
+		{
+			if (mask & (1 << lane))
+				visible.push_back(i + lane);
+		}
+	}
+#elif CULLING_SSE
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&m_CenterX[i]);
+		__m128 cy = _mm_loadu_ps(&m_CenterY[i]);
+		__m128 cz = _mm_loadu_ps(&m_CenterZ[i]);
+		__m128 ex = _mm_loadu_ps(&m_ExtentX[i]);
+		__m128 ey = _mm_loadu_ps(&m_ExtentY[i]);
+		__m128 ez = _mm_loadu_ps(&m_ExtentZ[i]);
+		__m128 radius = _mm_loadu_ps(&m_Radius[i]);
+
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (const glm::vec4& plane : frustum.Planes)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+				_mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			__m128 reach = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::fabs(plane.x))), _mm_mul_ps(ey, _mm_set1_ps(std::fabs(plane.y)))),
+				_mm_add_ps(_mm_mul_ps(ez, _mm_set1_ps(std::fabs(plane.z))), radius));
+			// distance + reach >= 0, the object reaches the inner side of the plane
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), zero));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (unsigned int lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1 << lane))
+				visible.push_back(i + lane);
+		}
+	}
+#endif
+
+	CullRange(frustum, i, count, visible);
+}
+
+void CullingSet::CullRange(const Frustum& frustum, unsigned int begin, unsigned int end, std::vector<unsigned int>& visible) const
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.Planes)
+		{
+			// Same order of operations as the vector loops, so both agree on the edge cases
+			float distance = (m_CenterX[i] * plane.x + m_CenterY[i] * plane.y) + (m_CenterZ[i] * plane.z + plane.w);
+			float reach = (m_ExtentX[i] * std::fabs(plane.x) + m_ExtentY[i] * std::fabs(plane.y)) + (m_ExtentZ[i] * std::fabs(plane.z) + m_Radius[i]);
+			inside &= distance + reach >= 0.0f;
+		}
+		if (inside)
+			visible.push_back(i);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+struct BoundingBox
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+
+	inline glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+	inline glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+	// The box around this one after transforming it, e.g. from model to world space
+	BoundingBox Transform(const glm::mat4& transform) const;
+};
+
+struct BoundingSphere
+{
+	glm::vec3 Center;
+	float Radius;
+};
+
+/**
+ * The six planes of a view-projection matrix's clip volume (Gribb and Hartmann), normals
+ * pointing inwards and normalized, so plane.xyz . p + plane.w is the signed distance.
+ * Works for ortho and perspective projections alike.
+ */
+struct Frustum
+{
+	enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+	glm::vec4 Planes[PlaneCount];
+
+	static Frustum FromMatrix(const glm::mat4& viewProjection);
+};
+
+/**
+ * Bounding volumes of a frame's objects, culled against a frustum in one pass.
+ *
+ * Stored as structure of arrays (center, extents and radius each in their own array) so
+ * the plane tests run 8 objects at a time with AVX, 4 with SSE, and one at a time
+ * elsewhere. Boxes and spheres share the arrays: a box has no radius, a sphere no
+ * extents, and a plane rejects an object if it is further outside than
+ * |n| . extents + radius.
+ */
+class CullingSet
+{
+private:
+	std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+	std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+	std::vector<float> m_Radius;
+public:
+	// Both return the object's index, counting from 0 after every Clear()
+	unsigned int Add(const BoundingBox& box);
+	unsigned int Add(const BoundingSphere& sphere);
+	void Clear();
+
+	// Replaces `visible` with the indices of the objects at least partly inside, in order
+	void Cull(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+
+	inline unsigned int GetCount() const { return (unsigned int)m_CenterX.size(); }
+	// Number of floats processed at once by Cull on this build
+	static unsigned int GetSimdWidth();
+private:
+	unsigned int Add(const glm::vec3& center, const glm::vec3& extents, float radius);
+	// Scalar test of objects [begin, end), for the tail the vector loop leaves
+	void CullRange(const Frustum& frustum, unsigned int begin, unsigned int end, std::vector<unsigned int>& visible) const;
+};
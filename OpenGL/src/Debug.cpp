@@ -96,7 +96,7 @@ void APIENTRY glDebugCallback(
 	if (severity != GL_DEBUG_SEVERITY_NOTIFICATION) 
 	{
 		printf("glDebugMessage:\n%s \n type = %s source = %s severity = %s\n", message, msgType.c_str(), msgSource.c_str(), msgSeverity.c_str());
-		__debugbreak();
+		DEBUG_BREAK();
 	}
 }
 
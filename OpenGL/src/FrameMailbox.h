@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * Hands frames from one producer thread to one consumer thread without locks or waiting.
+ *
+ * Three buffers: the producer fills one, the consumer reads another, and the third is
+ * the most recently published. Publish() swaps the filled buffer with that one, Acquire()
+ * swaps the read buffer with it if something new was published. The producer never
+ * waits for the consumer and the consumer always gets the newest complete frame, frames
+ * it was too slow for are skipped. Buffers are reused, so anything they allocated (e.g.
+ * vector capacity) carries over.
+ */
+template<typename T>
+class FrameMailbox
+{
+private:
+	static const unsigned int IndexMask = 3;
+	static const unsigned int NewBit = 4;
+
+	T m_Buffers[3];
+	unsigned int m_Write; // producer only
+	unsigned int m_Read;  // consumer only
+	std::atomic<unsigned int> m_Shared;
+public:
+	FrameMailbox()
+		: m_Write(0), m_Read(1), m_Shared(2)
+	{
+	}
+
+	// Producer: the buffer to fill, still holds whatever frame was in it before
+	inline T& GetWriteBuffer() { return m_Buffers[m_Write]; }
+
+	// Producer: makes the write buffer the newest frame and hands back another one
+	void Publish()
+	{
+		// release so the consumer sees the whole frame, acquire so we don't start
+		// writing into the buffer before the consumer is done with it
+		m_Write = m_Shared.exchange(m_Write | NewBit, std::memory_order_acq_rel) & IndexMask;
+	}
+
+	// Consumer: swaps in the newest frame, false if nothing was published since last time
+	bool Acquire()
+	{
+		if (!(m_Shared.load(std::memory_order_relaxed) & NewBit))
+			return false;
+		m_Read = m_Shared.exchange(m_Read, std::memory_order_acq_rel) & IndexMask;
+		return true;
+	}
+
+	// Consumer: the frame swapped in by the last successful Acquire()
+	inline const T& GetReadBuffer() const { return m_Buffers[m_Read]; }
+
+	// Drops a published frame nobody read yet, only while neither thread is using it
+	inline void Reset() { m_Shared.fetch_and(IndexMask, std::memory_order_relaxed); }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "RenderQueue.h"
+
+/**
+ * Everything a test needs to draw one frame, built by Test::OnBuildFrame without touching
+ * GL (possibly on the simulation thread) and read by Test::OnRenderFrame on the GL
+ * thread. Once published it is never written to again until it comes back for reuse.
+ *
+ * Draws may point at GL objects owned by the test, only their handles are read while
+ * building (e.g. for sort keys) and those don't change after the test is constructed.
+ */
+struct FramePacket
+{
+	unsigned long long Frame; // number of packets the builder published before this one
+	float Time;               // simulated seconds
+	float Interpolation;      // see Renderer::GetInterpolation
+	unsigned int WindowX, WindowY;
+
+	glm::mat4 Projection;
+	glm::mat4 View;
+	std::vector<glm::mat4> Transforms; // per instance
+	std::vector<DrawPacket> Draws;
+
+	FramePacket()
+		: Frame(0), Time(0.0f), Interpolation(1.0f), WindowX(0), WindowY(0),
+		  Projection(1.0f), View(1.0f)
+	{
+	}
+
+	// Empties the lists but keeps their memory
+	inline void Clear()
+	{
+		Transforms.clear();
+		Draws.clear();
+	}
+};
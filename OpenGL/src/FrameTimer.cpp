@@ -0,0 +1,40 @@
+#include "FrameTimer.h"
+
+#include <cmath>
+
+FrameTimer::FrameTimer(double step, unsigned int maxSteps)
+	: m_Step(step),
+	  m_MaxSteps(maxSteps),
+	  m_Accumulator(0.0),
+	  m_FrameTime(0.0),
+	  m_Steps(0),
+	  m_DroppedSteps(0)
+{
+	Reset();
+}
+
+void FrameTimer::Reset()
+{
+	m_Last = Clock::now();
+	m_Accumulator = 0.0;
+}
+
+unsigned int FrameTimer::Advance()
+{
+	Clock::time_point now = Clock::now();
+	m_FrameTime = std::chrono::duration<double>(now - m_Last).count();
+	m_Last = now;
+
+	m_Accumulator += m_FrameTime;
+	m_Steps = (unsigned int)(m_Accumulator / m_Step);
+	if (m_Steps > m_MaxSteps)
+	{
+		m_DroppedSteps += m_Steps - m_MaxSteps;
+		m_Steps = m_MaxSteps;
+	}
+	m_Accumulator -= m_Steps * m_Step;
+
+	// Only keep the partial step of whatever was dropped
+	m_Accumulator = std::fmod(m_Accumulator, m_Step);
+	return m_Steps;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * Frame clock with a fixed timestep accumulator.
+ *
+ * Every frame, Advance() adds the real time since the last call and returns how many
+ * updates of GetStep() seconds are due; whatever is left over becomes GetAlpha(), the
+ * fraction of a step rendering should interpolate by. So simulation runs at the same
+ * rate whether the frame rate is capped by vsync or not.
+ *
+ * A frame that took too long (a breakpoint, a dragged window) would otherwise owe
+ * dozens of updates, each making the next frame slower still. At most MaxSteps are run
+ * and the rest of the backlog is dropped, the simulation slows down instead.
+ */
+class FrameTimer
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	Clock::time_point m_Last;
+	double m_Step;
+	unsigned int m_MaxSteps;
+	double m_Accumulator;
+	double m_FrameTime;
+	unsigned int m_Steps;
+	unsigned long long m_DroppedSteps;
+public:
+	FrameTimer(double step = 1.0 / 60.0, unsigned int maxSteps = 5);
+
+	// Forgets the time since the last frame, e.g. after a long load
+	void Reset();
+	// Number of fixed updates to run this frame
+	unsigned int Advance();
+
+	inline float GetStep() const { return (float)m_Step; }
+	// Between 0 (the last update's state) and 1 (one more step ahead)
+	inline float GetAlpha() const { return (float)(m_Accumulator / m_Step); }
+	// Real seconds between the last two calls to Advance
+	inline double GetFrameTime() const { return m_FrameTime; }
+	inline unsigned int GetSteps() const { return m_Steps; }
+	inline unsigned long long GetDroppedSteps() const { return m_DroppedSteps; }
+};
@@ -0,0 +1,201 @@
+#include "GLState.h"
+
+// Never a valid GL name, forces the next call to be issued
+static const unsigned int s_Unknown = 0xffffffff;
+
+static GLState s_DefaultState;
+thread_local GLState* GLState::s_Current = &s_DefaultState;
+
+GLState::GLState()
+{
+	Invalidate();
+	ResetCounters();
+}
+
+GLState& GLState::Current()
+{
+	return *s_Current;
+}
+
+void GLState::MakeCurrent(GLState* state)
+{
+	s_Current = state ? state : &s_DefaultState;
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+	if (Changed(Program, m_Program, program))
+		glUseProgram(program);
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+	if (Changed(VertexArray, m_VertexArray, vertexArray))
+		glBindVertexArray(vertexArray);
+}
+
+void GLState::BindArrayBuffer(unsigned int buffer)
+{
+	if (Changed(ArrayBuffer, m_ArrayBuffer, buffer))
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void GLState::BindElementBuffer(unsigned int buffer)
+{
+	// Without a known VAO there is nothing to key the cache on
+	if (m_VertexArray == s_Unknown)
+	{
+		m_Counters[ElementBuffer].Issued++;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+		return;
+	}
+
+	unsigned int& cached = m_ElementBuffers.emplace(m_VertexArray, s_Unknown).first->second;
+	if (Changed(ElementBuffer, cached, buffer))
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+}
+
+void GLState::SetActiveTexture(unsigned int unit)
+{
+	if (Changed(ActiveTexture, m_ActiveTexture, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+unsigned int GLState::GetActiveTexture() const
+{
+	return m_ActiveTexture == s_Unknown ? 0 : m_ActiveTexture;
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	int targetIndex = -1;
+	if (target == GL_TEXTURE_2D)
+		targetIndex = Texture2D;
+	else if (target == GL_TEXTURE_2D_ARRAY)
+		targetIndex = Texture2DArray;
+
+	if (targetIndex < 0 || unit >= MaxTextureUnits)
+	{
+		SetActiveTexture(unit);
+		m_Counters[Texture].Issued++;
+		glBindTexture(target, texture);
+		return;
+	}
+
+	if (m_Textures[unit][targetIndex] == texture)
+	{
+		m_Counters[Texture].Skipped++;
+		return;
+	}
+
+	SetActiveTexture(unit);
+	Changed(Texture, m_Textures[unit][targetIndex], texture);
+	glBindTexture(target, texture);
+}
+
+void GLState::SetBlend(bool enabled)
+{
+	if (m_BlendEnabled == (int)enabled)
+	{
+		m_Counters[Blend].Skipped++;
+		return;
+	}
+
+	m_BlendEnabled = enabled;
+	m_Counters[Blend].Issued++;
+	if (enabled)
+		glEnable(GL_BLEND);
+	else
+		glDisable(GL_BLEND);
+}
+
+void GLState::SetBlendFunc(unsigned int src, unsigned int dst)
+{
+	if (m_BlendSrc == src && m_BlendDst == dst)
+	{
+		m_Counters[Blend].Skipped++;
+		return;
+	}
+
+	m_BlendSrc = src;
+	m_BlendDst = dst;
+	m_Counters[Blend].Issued++;
+	glBlendFunc(src, dst);
+}
+
+void GLState::OnDeleteProgram(unsigned int program)
+{
+	// A deleted program stays in use until something else is bound, but the name
+	// may come back for a new program so stop trusting the cache
+	if (m_Program == program)
+		m_Program = s_Unknown;
+}
+
+void GLState::OnDeleteVertexArray(unsigned int vertexArray)
+{
+	m_ElementBuffers.erase(vertexArray);
+	if (m_VertexArray == vertexArray)
+		m_VertexArray = 0;
+}
+
+void GLState::OnDeleteBuffer(unsigned int buffer)
+{
+	if (m_ArrayBuffer == buffer)
+		m_ArrayBuffer = 0;
+
+	for (auto& entry : m_ElementBuffers)
+	{
+		if (entry.second == buffer)
+			entry.second = s_Unknown;
+	}
+}
+
+void GLState::OnDeleteTexture(unsigned int texture)
+{
+	for (unsigned int unit = 0; unit < MaxTextureUnits; unit++)
+	{
+		for (unsigned int target = 0; target < TextureTargetCount; target++)
+		{
+			if (m_Textures[unit][target] == texture)
+				m_Textures[unit][target] = 0;
+		}
+	}
+}
+
+void GLState::Invalidate()
+{
+	m_Program = s_Unknown;
+	m_VertexArray = s_Unknown;
+	m_ArrayBuffer = s_Unknown;
+	m_ElementBuffers.clear();
+	m_ActiveTexture = s_Unknown;
+	for (unsigned int unit = 0; unit < MaxTextureUnits; unit++)
+	{
+		for (unsigned int target = 0; target < TextureTargetCount; target++)
+			m_Textures[unit][target] = s_Unknown;
+	}
+	m_BlendEnabled = -1;
+	m_BlendSrc = s_Unknown;
+	m_BlendDst = s_Unknown;
+}
+
+void GLState::ResetCounters()
+{
+	for (unsigned int i = 0; i < BindingCount; i++)
+		m_Counters[i] = { 0, 0 };
+}
+
+const char* GLState::GetBindingName(Binding binding)
+{
+	switch (binding)
+	{
+	case Program:       return "Program";
+	case VertexArray:   return "Vertex array";
+	case ArrayBuffer:   return "Array buffer";
+	case ElementBuffer: return "Element buffer";
+	case ActiveTexture: return "Active texture";
+	case Texture:       return "Texture";
+	case Blend:         return "Blend";
+	default:            return "?";
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+/**
+ * Shadow copy of the GL binding state of one context. All Bind() calls of our wrapper
+ * classes go through here so that binding what is already bound costs nothing.
+ *
+ * Anything that changes GL state behind our back (e.g. ImGui's renderer) must be
+ * followed by Invalidate(), after which the next call of every kind is issued again.
+ */
+class GLState
+{
+public:
+	enum Binding
+	{
+		Program,
+		VertexArray,
+		ArrayBuffer,
+		ElementBuffer,
+		ActiveTexture,
+		Texture,
+		Blend,
+		BindingCount
+	};
+
+	struct Counters
+	{
+		unsigned int Issued;
+		unsigned int Skipped;
+	};
+
+	static const unsigned int MaxTextureUnits = 32;
+private:
+	// Texture targets we cache, anything else is always passed through
+	enum TextureTarget
+	{
+		Texture2D,
+		Texture2DArray,
+		TextureTargetCount
+	};
+
+	unsigned int m_Program;
+	unsigned int m_VertexArray;
+	unsigned int m_ArrayBuffer;
+	// The element buffer binding is part of the VAO, so it is cached per VAO
+	std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+	unsigned int m_ActiveTexture;
+	unsigned int m_Textures[MaxTextureUnits][TextureTargetCount];
+	int m_BlendEnabled; // -1 = unknown
+	unsigned int m_BlendSrc;
+	unsigned int m_BlendDst;
+
+	Counters m_Counters[BindingCount];
+
+	static thread_local GLState* s_Current;
+public:
+	GLState();
+
+	// The state of whichever context is current on this thread, per thread like the GL
+	// context itself. Threads without a context (simulation, jobs) must not use it
+	static GLState& Current();
+	static void MakeCurrent(GLState* state);
+
+	void UseProgram(unsigned int program);
+	void BindVertexArray(unsigned int vertexArray);
+	void BindArrayBuffer(unsigned int buffer);
+	void BindElementBuffer(unsigned int buffer);
+	void SetActiveTexture(unsigned int unit);
+	void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+	void SetBlend(bool enabled);
+	void SetBlendFunc(unsigned int src, unsigned int dst);
+
+	// Deleting a bound object resets the binding to 0 in GL, mirror that
+	void OnDeleteProgram(unsigned int program);
+	void OnDeleteVertexArray(unsigned int vertexArray);
+	void OnDeleteBuffer(unsigned int buffer);
+	void OnDeleteTexture(unsigned int texture);
+
+	void Invalidate();
+
+	// Unit 0 if unknown, binding through it will then make unit 0 active
+	unsigned int GetActiveTexture() const;
+	inline const Counters& GetCounters(Binding binding) const { return m_Counters[binding]; }
+	void ResetCounters();
+
+	static const char* GetBindingName(Binding binding);
+private:
+	// Returns true if the call has to be issued, updating the counters either way
+	inline bool Changed(Binding binding, unsigned int& cached, unsigned int value)
+	{
+		if (cached == value)
+		{
+			m_Counters[binding].Skipped++;
+			return false;
+		}
+		cached = value;
+		m_Counters[binding].Issued++;
+		return true;
+	}
+};
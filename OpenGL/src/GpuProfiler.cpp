@@ -0,0 +1,269 @@
+#include "GpuProfiler.h"
+
+#include <cstring>
+
+#include <GL/glew.h>
+
+#include "imgui/imgui.h"
+
+GpuProfiler* GpuProfiler::s_Current = nullptr;
+
+GpuProfiler::GpuProfiler()
+	: m_Supported(GLEW_VERSION_3_3 || GLEW_ARB_timer_query),
+	  m_Enabled(true),
+	  m_InFrame(false),
+	  m_FrameIndex(0),
+	  m_DroppedFrames(0),
+	  m_MaxDepth(~0u),
+	  m_FrameTimeSink(nullptr)
+{
+	for (Frame& frame : m_Frames)
+	{
+		frame.QueryCount = 0;
+		frame.Pending = false;
+	}
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	if (s_Current == this)
+		s_Current = nullptr;
+
+	for (Frame& frame : m_Frames)
+	{
+		if (!frame.Queries.empty())
+			glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data());
+	}
+}
+
+void GpuProfiler::MakeCurrent(GpuProfiler* profiler)
+{
+	s_Current = profiler;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	if (!m_Supported || !m_Enabled)
+		return;
+
+	Resolve();
+
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+	if (frame.Pending)
+	{
+		// Still in flight after a full lap, waiting for it would stall the pipeline
+		frame.Pending = false;
+		m_DroppedFrames++;
+	}
+
+	frame.QueryCount = 0;
+	frame.Scopes.clear();
+	m_Stack.clear();
+	m_InFrame = true;
+
+	BeginScope("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+	if (!m_InFrame)
+		return;
+
+	// Closes the root, and anything left open by mistake
+	while (!m_Stack.empty())
+		EndScope();
+
+	m_Frames[m_FrameIndex % FrameLatency].Pending = true;
+	m_FrameIndex++;
+	m_InFrame = false;
+}
+
+void GpuProfiler::BeginScope(const char* name)
+{
+	if (!m_InFrame)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+	if (frame.Scopes.size() >= MaxScopesPerFrame || m_Stack.size() > m_MaxDepth)
+	{
+		m_Stack.push_back(-1);
+		return;
+	}
+
+	Scope scope;
+	scope.Name = name;
+	scope.Parent = m_Stack.empty() ? -1 : m_Stack.back();
+	scope.BeginQuery = AllocateQuery(frame);
+	scope.EndQuery = scope.BeginQuery; // until the scope ends
+
+	glQueryCounter(frame.Queries[scope.BeginQuery], GL_TIMESTAMP);
+
+	m_Stack.push_back((int)frame.Scopes.size());
+	frame.Scopes.push_back(scope);
+}
+
+void GpuProfiler::EndScope()
+{
+	if (!m_InFrame || m_Stack.empty())
+		return;
+
+	int index = m_Stack.back();
+	m_Stack.pop_back();
+	if (index < 0)
+		return;
+
+	Frame& frame = m_Frames[m_FrameIndex % FrameLatency];
+	Scope& scope = frame.Scopes[index];
+	scope.EndQuery = AllocateQuery(frame);
+
+	glQueryCounter(frame.Queries[scope.EndQuery], GL_TIMESTAMP);
+}
+
+unsigned int GpuProfiler::AllocateQuery(Frame& frame)
+{
+	if (frame.QueryCount == frame.Queries.size())
+	{
+		// Double the pool, it settles after the first few frames
+		size_t count = frame.Queries.empty() ? 64 : frame.Queries.size();
+		frame.Queries.resize(frame.Queries.size() + count);
+		glGenQueries((GLsizei)count, frame.Queries.data() + frame.Queries.size() - count);
+	}
+	return frame.QueryCount++;
+}
+
+void GpuProfiler::Resolve()
+{
+	// Oldest frame first, the GPU finishes them in order so the first one that isn't
+	// ready means none of the later ones are either
+	for (unsigned int i = 0; i < FrameLatency; i++)
+	{
+		Frame& frame = m_Frames[(m_FrameIndex + i) % FrameLatency];
+		if (!frame.Pending)
+			continue;
+
+		// The root's end is the last query of the frame
+		GLint available = 0;
+		glGetQueryObjectiv(frame.Queries[frame.Scopes[0].EndQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		ReadBack(frame);
+		frame.Pending = false;
+	}
+}
+
+void GpuProfiler::ReadBack(Frame& frame)
+{
+	m_Timestamps.resize(frame.QueryCount);
+	for (unsigned int i = 0; i < frame.QueryCount; i++)
+		glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &m_Timestamps[i]);
+
+	// Merge same named siblings into a tree first, then flatten it depth first
+	struct TreeNode
+	{
+		const char* Name;
+		unsigned int Count;
+		uint64_t Nanoseconds;
+		std::vector<size_t> Children;
+	};
+
+	std::vector<TreeNode> tree;
+	std::vector<size_t> scopeNodes(frame.Scopes.size());
+	tree.reserve(frame.Scopes.size());
+
+	// Scopes are stored in the order they began, so a parent always comes before its children
+	for (size_t i = 0; i < frame.Scopes.size(); i++)
+	{
+		const Scope& scope = frame.Scopes[i];
+		uint64_t duration = m_Timestamps[scope.EndQuery] - m_Timestamps[scope.BeginQuery];
+
+		size_t node = tree.size();
+		if (scope.Parent >= 0)
+		{
+			for (size_t child : tree[scopeNodes[scope.Parent]].Children)
+			{
+				if (strcmp(tree[child].Name, scope.Name) == 0)
+				{
+					node = child;
+					break;
+				}
+			}
+		}
+
+		if (node == tree.size())
+		{
+			tree.push_back({ scope.Name, 0, 0, {} });
+			if (scope.Parent >= 0)
+				tree[scopeNodes[scope.Parent]].Children.push_back(node);
+		}
+
+		tree[node].Count++;
+		tree[node].Nanoseconds += duration;
+		scopeNodes[i] = node;
+	}
+
+	m_Results.clear();
+	std::vector<std::pair<size_t, unsigned int>> stack; // node, depth
+	stack.push_back({ 0, 0 });
+	while (!stack.empty())
+	{
+		size_t node = stack.back().first;
+		unsigned int depth = stack.back().second;
+		stack.pop_back();
+
+		m_Results.push_back({ tree[node].Name, depth, tree[node].Count, tree[node].Nanoseconds / 1000000.0 });
+
+		const std::vector<size_t>& children = tree[node].Children;
+		for (auto it = children.rbegin(); it != children.rend(); ++it)
+			stack.push_back({ *it, depth + 1 });
+	}
+
+	if (m_FrameTimeSink)
+		m_FrameTimeSink->push_back(m_Results[0].Milliseconds);
+}
+
+void GpuProfiler::OnImGuiRender()
+{
+	ImGui::Begin("GPU Profiler");
+
+	if (!m_Supported)
+	{
+		ImGui::Text("Timer queries are not supported");
+		ImGui::End();
+		return;
+	}
+
+	ImGui::Checkbox("Enabled", &m_Enabled);
+	ImGui::SameLine();
+	ImGui::Text("%u frames behind, %u dropped", FrameLatency, m_DroppedFrames);
+	ImGui::Separator();
+
+	size_t index = 0;
+	while (index < m_Results.size())
+		DrawNode(index);
+
+	ImGui::End();
+}
+
+void GpuProfiler::DrawNode(size_t& index) const
+{
+	const Node& node = m_Results[index++];
+	bool hasChildren = index < m_Results.size() && m_Results[index].Depth > node.Depth;
+
+	ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_DefaultOpen | (hasChildren ? 0 : ImGuiTreeNodeFlags_Leaf);
+	bool open = node.Count > 1
+		? ImGui::TreeNodeEx(node.Name, flags, "%-20s %7.3f ms  (x%u)", node.Name, node.Milliseconds, node.Count)
+		: ImGui::TreeNodeEx(node.Name, flags, "%-20s %7.3f ms", node.Name, node.Milliseconds);
+
+	if (open)
+	{
+		while (index < m_Results.size() && m_Results[index].Depth > node.Depth)
+			DrawNode(index);
+		ImGui::TreePop();
+	}
+	else
+	{
+		while (index < m_Results.size() && m_Results[index].Depth > node.Depth)
+			index++;
+	}
+}
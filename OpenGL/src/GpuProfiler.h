@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Measures where GPU time goes with glQueryCounter(GL_TIMESTAMP) pairs around named scopes.
+ *
+ * Queries come from a per-frame pool and are read back FrameLatency frames later, only
+ * once the driver reports them available, so the CPU never waits on the GPU. A frame
+ * whose results still aren't there when its slot comes around again is dropped.
+ *
+ * Scopes nest and the results of a frame form a tree below an implicit "Frame" root,
+ * siblings with the same name (e.g. every Renderer::Draw) are merged into one node.
+ * Scope names must outlive the profiler, string literals are the intended use.
+ *
+ * Usage:
+ *   profiler.BeginFrame();
+ *   { GpuScope scope("Scene"); ... }
+ *   profiler.EndFrame();
+ */
+class GpuProfiler
+{
+public:
+	static const unsigned int FrameLatency = 4;
+	static const unsigned int MaxScopesPerFrame = 1024;
+
+	// One node of the resolved tree, stored depth first
+	struct Node
+	{
+		const char* Name;
+		unsigned int Depth;
+		unsigned int Count; // merged siblings
+		double Milliseconds;
+	};
+private:
+	struct Scope
+	{
+		const char* Name;
+		int Parent; // index into Frame::Scopes, -1 for the root
+		unsigned int BeginQuery;
+		unsigned int EndQuery;
+	};
+
+	struct Frame
+	{
+		std::vector<unsigned int> Queries; // grows on demand, reused every lap
+		unsigned int QueryCount;
+		std::vector<Scope> Scopes;
+		bool Pending; // issued, not read back yet
+	};
+
+	bool m_Supported;
+	bool m_Enabled;
+	bool m_InFrame;
+	Frame m_Frames[FrameLatency];
+	unsigned int m_FrameIndex;
+	std::vector<int> m_Stack; // open scopes, -1 for ones over the limit
+	std::vector<uint64_t> m_Timestamps;
+	std::vector<Node> m_Results;
+	unsigned int m_DroppedFrames;
+	unsigned int m_MaxDepth;
+	std::vector<double>* m_FrameTimeSink;
+
+	static GpuProfiler* s_Current;
+public:
+	GpuProfiler();
+	~GpuProfiler();
+
+	// The profiler GpuScope records into, null turns scopes into no-ops
+	static inline GpuProfiler* GetCurrent() { return s_Current; }
+	static void MakeCurrent(GpuProfiler* profiler);
+
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginScope(const char* name);
+	void EndScope();
+
+	inline bool IsSupported() const { return m_Supported; }
+	inline bool IsEnabled() const { return m_Enabled; }
+	inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+	// Scopes nested deeper than this are skipped, 0 times whole frames only
+	inline void SetMaxDepth(unsigned int depth) { m_MaxDepth = depth; }
+	// Every frame read back from now on appends its total time (ms) here, null to stop
+	inline void SetFrameTimeSink(std::vector<double>* sink) { m_FrameTimeSink = sink; }
+
+	// Reads back every frame the GPU has finished, BeginFrame() does this too
+	void Resolve();
+
+	// The newest frame read back, empty until the first one arrives
+	inline const std::vector<Node>& GetResults() const { return m_Results; }
+	inline unsigned int GetDroppedFrames() const { return m_DroppedFrames; }
+
+	void OnImGuiRender();
+private:
+	unsigned int AllocateQuery(Frame& frame);
+	void ReadBack(Frame& frame);
+	void DrawNode(size_t& index) const;
+};
+
+// Times everything issued until the end of the enclosing block
+class GpuScope
+{
+private:
+	GpuProfiler* m_Profiler;
+public:
+	GpuScope(const char* name)
+		: m_Profiler(GpuProfiler::GetCurrent())
+	{
+		if (m_Profiler)
+			m_Profiler->BeginScope(name);
+	}
+
+	~GpuScope()
+	{
+		if (m_Profiler)
+			m_Profiler->EndScope();
+	}
+
+	GpuScope(const GpuScope&) = delete;
+	GpuScope& operator=(const GpuScope&) = delete;
+};
@@ -0,0 +1,205 @@
+#include "HeadlessContext.h"
+
+#include <iostream>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#endif
+
+#include "ShaderCache.h"
+
+HeadlessContext::HeadlessContext()
+	: m_Backend(Backend::None),
+	  m_Width(0),
+	  m_Height(0),
+	  m_EglDisplay(nullptr),
+	  m_EglContext(nullptr),
+	  m_Window(nullptr),
+	  m_Framebuffer(0),
+	  m_ColorBuffer(0)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+	Destroy();
+}
+
+bool HeadlessContext::Create(int width, int height, bool allowEgl /*= true*/)
+{
+	m_Width = width;
+	m_Height = height;
+
+	if (!(allowEgl && CreateEgl()) && !CreateHiddenWindow())
+	{
+		std::cout << "Warning: could not create a headless OpenGL 3.3 context" << std::endl;
+		return false;
+	}
+
+	// GLEW built for GLX can't find a GLX display under EGL, but it has already loaded
+	// every GL entry point by the time it checks for one
+	GLenum glewErr = glewInit();
+	if (glewErr != GLEW_OK && !(m_Backend == Backend::EglSurfaceless && glewErr == GLEW_ERROR_NO_GLX_DISPLAY))
+	{
+		std::cout << "Warning: GLEW init error: " << glewGetErrorString(glewErr) << std::endl;
+		Destroy();
+		return false;
+	}
+
+	glGenRenderbuffers(1, &m_ColorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenFramebuffers(1, &m_Framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Warning: the offscreen framebuffer is incomplete" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	BindFramebuffer();
+	return true;
+}
+
+void HeadlessContext::Destroy()
+{
+	if (m_Backend == Backend::None)
+		return;
+
+	if (m_Framebuffer)
+		glDeleteFramebuffers(1, &m_Framebuffer);
+	if (m_ColorBuffer)
+		glDeleteRenderbuffers(1, &m_ColorBuffer);
+	m_Framebuffer = 0;
+	m_ColorBuffer = 0;
+
+#ifdef __linux__
+	if (m_Backend == Backend::EglSurfaceless)
+	{
+		eglMakeCurrent((EGLDisplay)m_EglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext((EGLDisplay)m_EglDisplay, (EGLContext)m_EglContext);
+		eglTerminate((EGLDisplay)m_EglDisplay);
+	}
+#endif
+	if (m_Backend == Backend::HiddenWindow)
+	{
+		glfwDestroyWindow(m_Window);
+		glfwTerminate();
+	}
+
+	m_EglDisplay = nullptr;
+	m_EglContext = nullptr;
+	m_Window = nullptr;
+	m_Backend = Backend::None;
+}
+
+void HeadlessContext::BindFramebuffer() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glViewport(0, 0, m_Width, m_Height);
+}
+
+uint64_t HeadlessContext::HashPixels() const
+{
+	std::vector<unsigned char> pixels(m_Width * m_Height * 4);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return ShaderCache::Hash(pixels.data(), pixels.size());
+}
+
+const char* HeadlessContext::GetBackendName(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::EglSurfaceless: return "EGL surfaceless";
+	case Backend::HiddenWindow:   return "hidden GLFW window";
+	default:                      return "none";
+	}
+}
+
+bool HeadlessContext::CreateEgl()
+{
+#ifdef __linux__
+	// Without the surfaceless platform the default display needs a running X server
+	EGLDisplay display = EGL_NO_DISPLAY;
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay && clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+		return false;
+
+	// The default surface type is a window, which a surfaceless display has no configs for
+	const EGLint configAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	EGLContext context = EGL_NO_CONTEXT;
+	if (eglBindAPI(EGL_OPENGL_API) && eglChooseConfig(display, configAttributes, &config, 1, &configCount) && configCount > 0)
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		if (context != EGL_NO_CONTEXT)
+			eglDestroyContext(display, context);
+		eglTerminate(display);
+		return false;
+	}
+
+	m_EglDisplay = display;
+	m_EglContext = context;
+	m_Backend = Backend::EglSurfaceless;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HeadlessContext::CreateHiddenWindow()
+{
+	if (!glfwInit())
+		return false;
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	// The window only carries the context, its default framebuffer is never drawn to
+	m_Window = glfwCreateWindow(1, 1, "Headless", NULL, NULL);
+	if (!m_Window)
+	{
+		glfwTerminate();
+		return false;
+	}
+
+	glfwMakeContextCurrent(m_Window);
+	glfwSwapInterval(0);
+	m_Backend = Backend::HiddenWindow;
+	return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+struct GLFWwindow;
+
+/**
+ * An OpenGL 3.3 core context that never shows anything on screen, for benchmarks and CI.
+ *
+ * On Linux it first tries EGL without any surface (EGL_MESA_platform_surfaceless, so it
+ * runs on machines without a display or GPU through Mesa's llvmpipe). Everywhere else, or
+ * when that fails, it falls back to a hidden GLFW window. Either way frames are rendered
+ * into an offscreen framebuffer of the requested size which stays bound.
+ */
+class HeadlessContext
+{
+public:
+	enum class Backend
+	{
+		None,
+		EglSurfaceless,
+		HiddenWindow
+	};
+private:
+	Backend m_Backend;
+	int m_Width, m_Height;
+	void* m_EglDisplay;
+	void* m_EglContext;
+	GLFWwindow* m_Window;
+	unsigned int m_Framebuffer;
+	unsigned int m_ColorBuffer;
+public:
+	HeadlessContext();
+	~HeadlessContext();
+
+	// Creates the context, loads GL through GLEW and sets up the framebuffer. Prints
+	// a warning and returns false if no context could be created
+	bool Create(int width, int height, bool allowEgl = true);
+	void Destroy();
+
+	// Binds the offscreen framebuffer and sets the viewport to cover it
+	void BindFramebuffer() const;
+	// 64-bit hash of the framebuffer's pixels, for checking output stays the same
+	uint64_t HashPixels() const;
+
+	inline Backend GetBackend() const { return m_Backend; }
+	static const char* GetBackendName(Backend backend);
+private:
+	bool CreateEgl();
+	bool CreateHiddenWindow();
+};
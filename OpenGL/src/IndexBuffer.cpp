@@ -1,26 +1,30 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
+#include "GLState.h"
+#include "RenderStats.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
 	: m_Count(count)
 {
 	glGenBuffers(1, &m_RendererID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+	GLState::Current().BindElementBuffer(m_RendererID);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
+	RenderStats::Get().Add(RenderStats::BufferBytes, count * sizeof(unsigned int));
 }
 
 IndexBuffer::~IndexBuffer()
 {
+	GLState::Current().OnDeleteBuffer(m_RendererID);
 	glDeleteBuffers(1, &m_RendererID);
 }
 
 void IndexBuffer::Bind() const
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+	GLState::Current().BindElementBuffer(m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	GLState::Current().BindElementBuffer(0);
 }
 
@@ -0,0 +1,273 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "CpuProfiler.h"
+
+namespace {
+	// The worker running on this thread, if it is one
+	thread_local void* t_Worker = nullptr;
+
+	// Spins before a worker goes to sleep, waking one up costs far more
+	const int IdleSpins = 64;
+}
+
+JobSystem::WorkQueue::WorkQueue()
+	: m_Top(0), m_Bottom(0)
+{
+	for (std::atomic<Job*>& job : m_Jobs)
+		job.store(nullptr, std::memory_order_relaxed);
+}
+
+bool JobSystem::WorkQueue::Push(Job* job)
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	if (bottom - top >= Capacity)
+		return false;
+
+	m_Jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+	m_Bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Pop()
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_Top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		// Empty
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// Last one, race the thieves for it
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::WorkQueue::Steal()
+{
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return nullptr;
+
+	Job* job = m_Jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr; // lost to the owner or another thief
+	return job;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+	: m_Queued(0),
+	  m_Sleeping(0),
+	  m_Shutdown(false)
+{
+	if (workerCount == 0)
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		m_Workers.emplace_back(new Worker());
+		m_Workers.back()->System = this;
+		m_Workers.back()->RandomState = 0x9e3779b9u * (i + 1);
+	}
+	// Only start once every queue exists, workers steal from all of them
+	for (std::unique_ptr<Worker>& worker : m_Workers)
+		m_Threads.emplace_back(&JobSystem::WorkerMain, this, worker.get());
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Shutdown = true;
+	}
+	m_WorkAvailable.notify_all();
+	for (std::thread& thread : m_Threads)
+		thread.join();
+
+	// Nobody waited for these, drop them
+	for (Job* job : m_Shared)
+		delete job;
+}
+
+JobSystem& JobSystem::Get()
+{
+	static JobSystem system;
+	return system;
+}
+
+void JobSystem::Run(std::function<void()> task, JobCounter& counter, const JobCounter* dependency)
+{
+	counter.m_Pending.fetch_add(1, std::memory_order_relaxed);
+	Enqueue(new Job{ std::move(task), &counter, dependency });
+}
+
+void JobSystem::Enqueue(Job* job)
+{
+	// Counted before it can be taken, and paired with a sleeping worker checking
+	// m_Queued after counting itself in m_Sleeping
+	m_Queued.fetch_add(1);
+
+	Worker* worker = (Worker*)t_Worker;
+	if (!worker || worker->System != this || !worker->Queue.Push(job))
+	{
+		std::lock_guard<std::mutex> lock(m_SharedMutex);
+		m_Shared.push_back(job);
+	}
+
+	if (m_Sleeping.load() > 0)
+	{
+		{ std::lock_guard<std::mutex> lock(m_SleepMutex); }
+		m_WorkAvailable.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::FindJob()
+{
+	Worker* worker = (Worker*)t_Worker;
+	if (worker && worker->System != this)
+		worker = nullptr;
+
+	Job* job = worker ? worker->Queue.Pop() : nullptr;
+
+	if (!job)
+	{
+		std::lock_guard<std::mutex> lock(m_SharedMutex);
+		if (!m_Shared.empty())
+		{
+			job = m_Shared.front();
+			m_Shared.pop_front();
+		}
+	}
+
+	if (!job && !m_Workers.empty())
+	{
+		// Start at a random victim so thieves don't all pile onto the first worker
+		uint32_t random = worker ? worker->RandomState : (uint32_t)(size_t)&job;
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		if (worker)
+			worker->RandomState = random;
+
+		size_t count = m_Workers.size();
+		for (size_t i = 0; i < count && !job; i++)
+		{
+			Worker* victim = m_Workers[(random + i) % count].get();
+			if (victim != worker)
+				job = victim->Queue.Steal();
+		}
+	}
+
+	if (job)
+		m_Queued.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+bool JobSystem::RunOne()
+{
+	Job* job = FindJob();
+	if (!job)
+		return false;
+
+	if (job->Dependency && !job->Dependency->IsDone())
+	{
+		// Back of the shared queue, so whatever it depends on gets a chance to run first
+		m_Queued.fetch_add(1, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(m_SharedMutex);
+		m_Shared.push_back(job);
+		return false;
+	}
+
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	job->Task();
+	JobCounter* counter = job->Counter;
+	delete job;
+	counter->m_Pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!RunOne())
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::WorkerMain(Worker* worker)
+{
+	t_Worker = worker;
+	CpuProfiler::SetThreadName("Job Worker");
+
+	int idle = 0;
+	while (!m_Shutdown.load(std::memory_order_relaxed))
+	{
+		if (RunOne())
+		{
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < IdleSpins)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_Sleeping.fetch_add(1);
+		m_WorkAvailable.wait(lock, [this] { return m_Shutdown.load() || m_Queued.load() > 0; });
+		m_Sleeping.fetch_sub(1);
+		idle = 0;
+	}
+}
+
+void JobSystem::SplitRange(unsigned int begin, unsigned int end, unsigned int grain,
+	const std::function<void(unsigned int, unsigned int)>& body, JobCounter& counter)
+{
+	// Hand off the upper half until what is left fits in one grain
+	while (end - begin > grain)
+	{
+		unsigned int middle = begin + (end - begin) / 2;
+		Run([=, &body, &counter] { SplitRange(middle, end, grain, body, counter); }, counter);
+		end = middle;
+	}
+	body(begin, end);
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int grain, const std::function<void(unsigned int, unsigned int)>& body)
+{
+	if (count == 0)
+		return;
+
+	grain = std::max(grain, 1u);
+	if (count <= grain || m_Workers.empty())
+	{
+		body(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	SplitRange(0, count, grain, body, counter);
+	Wait(counter);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Counts the jobs started against it that haven't finished yet. Wait on it with
+ * JobSystem::Wait, or pass it as another job's dependency.
+ */
+class JobCounter
+{
+private:
+	friend class JobSystem;
+	std::atomic<unsigned int> m_Pending;
+public:
+	JobCounter() : m_Pending(0) {}
+
+	inline bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * Work-stealing job scheduler.
+ *
+ * Every worker has its own Chase-Lev deque: it pushes and pops jobs at the bottom without
+ * contention, idle workers steal the oldest jobs from the top of someone else's. Threads
+ * that aren't workers (the main thread, the simulation thread) submit to a shared queue
+ * instead, and help run jobs while they Wait.
+ *
+ * Jobs must not call GL, they run on whatever thread picks them up.
+ */
+class JobSystem
+{
+private:
+	struct Job
+	{
+		std::function<void()> Task;
+		JobCounter* Counter;
+		const JobCounter* Dependency;
+	};
+
+	// Fixed size Chase-Lev deque, see "Correct and Efficient Work-Stealing for Weak
+	// Memory Models" (Le et al. 2013)
+	class WorkQueue
+	{
+	private:
+		static const int64_t Capacity = 4096;
+
+		std::atomic<int64_t> m_Top;
+		std::atomic<int64_t> m_Bottom;
+		std::atomic<Job*> m_Jobs[Capacity];
+	public:
+		WorkQueue();
+
+		// Owner only, false when full
+		bool Push(Job* job);
+		Job* Pop();
+		// Any thread
+		Job* Steal();
+	};
+
+	struct Worker
+	{
+		JobSystem* System;
+		WorkQueue Queue;
+		uint32_t RandomState;
+	};
+
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+	std::vector<std::thread> m_Threads;
+
+	std::mutex m_SharedMutex;
+	std::deque<Job*> m_Shared; // from threads that aren't workers, and jobs whose dependency wasn't done
+
+	// Idle workers sleep until something is queued
+	std::mutex m_SleepMutex;
+	std::condition_variable m_WorkAvailable;
+	std::atomic<unsigned int> m_Queued;
+	std::atomic<unsigned int> m_Sleeping;
+	std::atomic<bool> m_Shutdown;
+public:
+	// workerCount 0 = one less than the hardware threads, the thread waiting makes up for it
+	JobSystem(unsigned int workerCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Shared by the whole engine, started on first use
+	static JobSystem& Get();
+
+	// Queues `task`, counted in `counter` until it has run. It won't start before
+	// `dependency` (if any) is done
+	void Run(std::function<void()> task, JobCounter& counter, const JobCounter* dependency = nullptr);
+
+	// Runs other jobs until `counter` is done
+	void Wait(const JobCounter& counter);
+
+	// Calls body(begin, end) over [0, count) in ranges of at most `grain` items and returns
+	// once all of them are done. Ranges are split in halves, so a thief always takes the
+	// biggest piece of work left
+	void ParallelFor(unsigned int count, unsigned int grain, const std::function<void(unsigned int, unsigned int)>& body);
+
+	inline unsigned int GetWorkerCount() const { return (unsigned int)m_Workers.size(); }
+private:
+	void WorkerMain(Worker* worker);
+	// Runs one job if there is any, false if it found nothing to do
+	bool RunOne();
+	Job* FindJob();
+	void Enqueue(Job* job);
+	void Execute(Job* job);
+	void SplitRange(unsigned int begin, unsigned int end, unsigned int grain,
+		const std::function<void(unsigned int, unsigned int)>& body, JobCounter& counter);
+};
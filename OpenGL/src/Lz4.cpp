@@ -0,0 +1,153 @@
+#include "Lz4.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+	// The format requires the last 5 bytes to be literals, and the last match to
+	// start at least 12 bytes before the end
+	const size_t LastLiterals = 5;
+	const size_t MatchStartLimit = 12;
+	const size_t MinMatch = 4;
+	const size_t MaxOffset = 65535;
+	const int HashBits = 16;
+
+	inline uint32_t Read32(const unsigned char* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	inline uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	// Lengths of 15 and over spill into extra bytes of 255 and a remainder
+	inline void WriteLength(std::vector<unsigned char>& out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			out.push_back(255);
+		out.push_back((unsigned char)length);
+	}
+
+	void WriteSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalCount, size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+		out.push_back((unsigned char)(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+		if (literalCount >= 15)
+			WriteLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+
+		// The final sequence is literals only
+		if (!matchLength)
+			return;
+
+		out.push_back((unsigned char)(offset & 0xff));
+		out.push_back((unsigned char)(offset >> 8));
+		if (matchCode >= 15)
+			WriteLength(out, matchCode - 15);
+	}
+
+	inline bool ReadLength(const unsigned char*& ip, const unsigned char* end, size_t& length)
+	{
+		unsigned char byte;
+		do
+		{
+			if (ip >= end)
+				return false;
+			byte = *ip++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+}
+
+std::vector<unsigned char> Lz4Compress(const unsigned char* src, size_t size)
+{
+	std::vector<unsigned char> out;
+	out.reserve(size + size / 255 + 16);
+
+	size_t anchor = 0;
+	if (size > MatchStartLimit)
+	{
+		std::vector<int64_t> table(1 << HashBits, -1);
+		size_t matchStartLimit = size - MatchStartLimit;
+		size_t matchEndLimit = size - LastLiterals;
+
+		size_t i = 0;
+		while (i < matchStartLimit)
+		{
+			uint32_t sequence = Read32(src + i);
+			uint32_t hash = Hash(sequence);
+			int64_t candidate = table[hash];
+			table[hash] = (int64_t)i;
+
+			if (candidate < 0 || i - (size_t)candidate > MaxOffset || Read32(src + candidate) != sequence)
+			{
+				i++;
+				continue;
+			}
+
+			size_t length = MinMatch;
+			while (i + length < matchEndLimit && src[candidate + length] == src[i + length])
+				length++;
+
+			WriteSequence(out, src + anchor, i - anchor, i - (size_t)candidate, length);
+			i += length;
+			anchor = i;
+		}
+	}
+
+	WriteSequence(out, src + anchor, size - anchor, 0, 0);
+	return out;
+}
+
+bool Lz4Decompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize)
+{
+	const unsigned char* ip = src;
+	const unsigned char* ipEnd = src + srcSize;
+	unsigned char* op = dst;
+	unsigned char* opEnd = dst + dstSize;
+
+	while (ip < ipEnd)
+	{
+		unsigned char token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !ReadLength(ip, ipEnd, literals))
+			return false;
+		if (literals > (size_t)(ipEnd - ip) || literals > (size_t)(opEnd - op))
+			return false;
+
+		if (literals)
+			memcpy(op, ip, literals);
+		op += literals;
+		ip += literals;
+
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return false;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dst))
+			return false;
+
+		size_t length = token & 15;
+		if (length == 15 && !ReadLength(ip, ipEnd, length))
+			return false;
+		length += MinMatch;
+		if (length > (size_t)(opEnd - op))
+			return false;
+
+		// Matches may overlap what they are writing (a run), so copy forwards bytewise
+		const unsigned char* match = op - offset;
+		for (size_t i = 0; i < length; i++)
+			*op++ = *match++;
+	}
+
+	return op == opEnd;
+}
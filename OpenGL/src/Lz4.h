@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * The LZ4 block format (no frame header, no checksums). Decompression is fast
+ * enough to be worth it on small text assets (shaders), images are already
+ * compressed and are better stored raw.
+ */
+
+// Greedy single pass compressor, fine for an offline packer
+std::vector<unsigned char> Lz4Compress(const unsigned char* src, size_t size);
+
+// Decompresses exactly dstSize bytes, returns false on corrupt input instead of
+// reading or writing out of bounds
+bool Lz4Decompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize);
@@ -0,0 +1,194 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+	// Going back to 8 bits needs more precision than 8 bits in, 14 bits of
+	// linear light keep the darkest sRGB steps apart
+	const int LinearToSrgbSize = 1 << 14;
+
+	struct SrgbTables
+	{
+		float ToLinear[256];
+		unsigned char ToSrgb[LinearToSrgbSize];
+
+		SrgbTables()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				float c = i / 255.0f;
+				ToLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+			}
+			for (int i = 0; i < LinearToSrgbSize; i++)
+			{
+				float l = i / (float)(LinearToSrgbSize - 1);
+				float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+				ToSrgb[i] = (unsigned char)(c * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	const SrgbTables& GetSrgbTables()
+	{
+		// Built on first use, safe to race for from the loader threads
+		static const SrgbTables tables;
+		return tables;
+	}
+
+	inline void AverageLinear(const unsigned char* row0, const unsigned char* row1, int x0, int x1, unsigned char* dst)
+	{
+		for (int c = 0; c < 4; c++)
+			dst[c] = (unsigned char)((row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c] + 2) >> 2);
+	}
+
+	// Sums one 2x2 quad per 32 bit lane pair: takes 4 source pixels of two rows, returns 2 pixels at 16 bits per channel
+	inline __m128i SumPairs(__m128i row0, __m128i row1)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero)); // p0, p1
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero)); // p2, p3
+		return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));            // p0+p1, p2+p3
+	}
+
+	// Returns the number of destination pixels written
+	int DownsampleRowLinear(const unsigned char* row0, const unsigned char* row1, int dstWidth, unsigned char* dst)
+	{
+		int x = 0;
+#if defined(__AVX2__)
+		const __m256i zero256 = _mm256_setzero_si256();
+		const __m256i round256 = _mm256_set1_epi16(2);
+		for (; x + 8 <= dstWidth; x += 8)
+		{
+			const __m256i* s0 = (const __m256i*)(row0 + x * 8);
+			const __m256i* s1 = (const __m256i*)(row1 + x * 8);
+
+			// Same as SumPairs, each 128 bit lane on its own
+			__m256i sums[2];
+			for (int i = 0; i < 2; i++)
+			{
+				__m256i a = _mm256_loadu_si256(s0 + i);
+				__m256i b = _mm256_loadu_si256(s1 + i);
+				__m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero256), _mm256_unpacklo_epi8(b, zero256));
+				__m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero256), _mm256_unpackhi_epi8(b, zero256));
+				sums[i] = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+				sums[i] = _mm256_srli_epi16(_mm256_add_epi16(sums[i], round256), 2);
+			}
+
+			// Packing works per lane too, which leaves the pixels as 0 1 4 5 | 2 3 6 7
+			__m256i packed = _mm256_packus_epi16(sums[0], sums[1]);
+			packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+			_mm256_storeu_si256((__m256i*)(dst + x * 4), packed);
+		}
+#endif
+		const __m128i round = _mm_set1_epi16(2);
+		for (; x + 4 <= dstWidth; x += 4)
+		{
+			const __m128i* s0 = (const __m128i*)(row0 + x * 8);
+			const __m128i* s1 = (const __m128i*)(row1 + x * 8);
+
+			__m128i left = SumPairs(_mm_loadu_si128(s0), _mm_loadu_si128(s1));
+			__m128i right = SumPairs(_mm_loadu_si128(s0 + 1), _mm_loadu_si128(s1 + 1));
+			left = _mm_srli_epi16(_mm_add_epi16(left, round), 2);
+			right = _mm_srli_epi16(_mm_add_epi16(right, round), 2);
+
+			_mm_storeu_si128((__m128i*)(dst + x * 4), _mm_packus_epi16(left, right));
+		}
+		return x;
+	}
+
+	void DownsampleRowSrgb(const unsigned char* row0, const unsigned char* row1, int srcWidth, int dstWidth, unsigned char* dst)
+	{
+		const SrgbTables& tables = GetSrgbTables();
+		const __m128 quarter = _mm_set1_ps(0.25f);
+		const __m128 scale = _mm_set_ps(255.0f, LinearToSrgbSize - 1.0f, LinearToSrgbSize - 1.0f, LinearToSrgbSize - 1.0f);
+
+		// The lookups are scalar, the averaging is done four channels at a time
+		auto load = [&tables](const unsigned char* p) {
+			return _mm_set_ps(p[3] / 255.0f, tables.ToLinear[p[2]], tables.ToLinear[p[1]], tables.ToLinear[p[0]]);
+		};
+
+		for (int x = 0; x < dstWidth; x++)
+		{
+			int x0 = std::min(x * 2, srcWidth - 1) * 4;
+			int x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+
+			__m128 sum = _mm_add_ps(_mm_add_ps(load(row0 + x0), load(row0 + x1)), _mm_add_ps(load(row1 + x0), load(row1 + x1)));
+			__m128i scaled = _mm_cvtps_epi32(_mm_mul_ps(_mm_mul_ps(sum, quarter), scale));
+
+			int values[4];
+			_mm_storeu_si128((__m128i*)values, scaled);
+			dst[x * 4 + 0] = tables.ToSrgb[values[0]];
+			dst[x * 4 + 1] = tables.ToSrgb[values[1]];
+			dst[x * 4 + 2] = tables.ToSrgb[values[2]];
+			dst[x * 4 + 3] = (unsigned char)values[3];
+		}
+	}
+}
+
+void DownsampleRGBA8(const unsigned char* src, int width, int height, unsigned char* dst, bool srgb)
+{
+	int dstWidth = std::max(1, width / 2);
+	int dstHeight = std::max(1, height / 2);
+
+	for (int y = 0; y < dstHeight; y++)
+	{
+		const unsigned char* row0 = src + std::min(y * 2, height - 1) * width * 4;
+		const unsigned char* row1 = src + std::min(y * 2 + 1, height - 1) * width * 4;
+		unsigned char* out = dst + y * dstWidth * 4;
+
+		if (srgb)
+		{
+			DownsampleRowSrgb(row0, row1, width, dstWidth, out);
+			continue;
+		}
+
+		// A one pixel wide source has no pairs to sum, the scalar tail handles it
+		int x = width > 1 ? DownsampleRowLinear(row0, row1, dstWidth, out) : 0;
+		for (; x < dstWidth; x++)
+			AverageLinear(row0, row1, std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1), out + x * 4);
+	}
+}
+
+int GetMipLevelCount(int width, int height)
+{
+	int levels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(1, width / 2);
+		height = std::max(1, height / 2);
+		levels++;
+	}
+	return levels;
+}
+
+MipChain GenerateMipChain(const unsigned char* rgba, int width, int height, bool srgb)
+{
+	MipChain chain;
+
+	// Every level is at most a quarter of the one above, reserve the lot up front
+	unsigned int size = 0;
+	int levelCount = GetMipLevelCount(width, height);
+	for (int i = 0, w = width, h = height; i < levelCount; i++, w = std::max(1, w / 2), h = std::max(1, h / 2))
+	{
+		chain.Levels.push_back({ w, h, size });
+		size += w * h * 4;
+	}
+
+	chain.Data.resize(size);
+	memcpy(chain.Data.data(), rgba, width * height * 4);
+
+	for (int i = 1; i < levelCount; i++)
+	{
+		const MipLevel& parent = chain.Levels[i - 1];
+		DownsampleRGBA8(chain.Data.data() + parent.Offset, parent.Width, parent.Height,
+			chain.Data.data() + chain.Levels[i].Offset, srgb);
+	}
+	return chain;
+}
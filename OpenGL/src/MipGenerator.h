@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct MipLevel
+{
+	int Width, Height;
+	unsigned int Offset; // into MipChain::Data
+};
+
+// An RGBA8 image and its mip levels, packed back to back from largest to smallest
+struct MipChain
+{
+	std::vector<unsigned char> Data;
+	std::vector<MipLevel> Levels;
+
+	inline const unsigned char* GetLevelData(size_t level) const { return Data.data() + Levels[level].Offset; }
+};
+
+/**
+ * Halves an RGBA8 image with a 2x2 box filter. Odd sizes drop their last row/column.
+ *
+ * With srgb the color channels are treated as sRGB encoded (as our PNGs are) and
+ * averaged in linear light, otherwise dark/bright edges lose their balance and the
+ * smaller levels darken. Alpha is always linear. Uses SSE2, or AVX2 when the build
+ * targets it.
+ */
+void DownsampleRGBA8(const unsigned char* src, int width, int height, unsigned char* dst, bool srgb);
+
+// Number of levels in a full chain down to 1x1
+int GetMipLevelCount(int width, int height);
+
+// Copies the top level and builds every level below it
+MipChain GenerateMipChain(const unsigned char* rgba, int width, int height, bool srgb);
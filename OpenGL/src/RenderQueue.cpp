@@ -0,0 +1,160 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+static constexpr UniformId u_Texture("u_Texture");
+static constexpr UniformId u_MVP("u_MVP");
+static constexpr UniformId u_Color("u_Color");
+
+static uint64_t QuantizeDepth(float depth)
+{
+	depth = std::min(std::max(depth, 0.0f), 1.0f);
+	return (uint64_t)(depth * 0xffffff);
+}
+
+RenderQueue::RenderQueue()
+	: m_SortEnabled(true),
+	  m_Stats{ 0, 0, 0, 0, 0 }
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+uint64_t RenderQueue::MakeSortKey(unsigned int layer, bool translucent, const Shader& shader,
+	const Texture* texture, const VertexArray& va, float depth)
+{
+	uint64_t layerBits   = layer & 0xf;
+	uint64_t shaderBits  = shader.GetRendererID() & 0x3ff;
+	uint64_t textureBits = (texture ? texture->GetRendererID() : 0) & 0xfff;
+	uint64_t vaoBits     = va.GetRendererID() & 0xfff;
+	uint64_t depthBits   = QuantizeDepth(depth);
+
+	uint64_t key = layerBits << 60;
+	if (translucent)
+	{
+		key |= 1ull << 59;
+		key |= (0xffffff - depthBits) << 35; // farthest first
+		key |= shaderBits << 25;
+		key |= textureBits << 13;
+		key |= vaoBits << 1;
+	}
+	else
+	{
+		key |= shaderBits << 49;
+		key |= textureBits << 37;
+		key |= vaoBits << 25;
+		key |= depthBits << 1;
+	}
+	return key;
+}
+
+void RenderQueue::Submit(const DrawPacket& packet)
+{
+	m_Packets.push_back(packet);
+}
+
+void RenderQueue::Execute(const Renderer& renderer)
+{
+	m_Stats = { 0, 0, 0, 0, 0 };
+
+	m_Sorted.resize(m_Packets.size());
+	for (unsigned int i = 0; i < m_Packets.size(); i++)
+		m_Sorted[i] = { m_Packets[i].SortKey, i };
+
+	if (m_SortEnabled)
+		Sort();
+
+	const Shader* lastProgram = nullptr;
+	const VertexArray* lastVao = nullptr;
+	const IndexBuffer* lastIbo = nullptr;
+	const Texture* lastTexture = nullptr;
+
+	for (const SortEntry& entry : m_Sorted)
+	{
+		DrawPacket& packet = m_Packets[entry.Index];
+
+		if (packet.Program != lastProgram)
+		{
+			packet.Program->Bind();
+			packet.Program->SetUniform1i(u_Texture, 0);
+			lastProgram = packet.Program;
+			m_Stats.ProgramBinds++;
+		}
+
+		if (packet.Vao != lastVao)
+		{
+			packet.Vao->Bind();
+			lastVao = packet.Vao;
+			lastIbo = nullptr; // the element buffer binding is part of the VAO state
+			m_Stats.VertexArrayBinds++;
+		}
+
+		if (packet.Ibo != lastIbo)
+		{
+			packet.Ibo->Bind();
+			lastIbo = packet.Ibo;
+			m_Stats.IndexBufferBinds++;
+		}
+
+		if (packet.TextureMap && packet.TextureMap != lastTexture)
+		{
+			packet.TextureMap->Bind(0);
+			lastTexture = packet.TextureMap;
+			m_Stats.TextureBinds++;
+		}
+
+		packet.Program->SetUniformMatrix4f(u_MVP, packet.MVP);
+		packet.Program->SetUniform4f(u_Color, packet.Color.r, packet.Color.g, packet.Color.b, packet.Color.a);
+
+		renderer.DrawIndexed(packet.Ibo->GetCount());
+		m_Stats.DrawCalls++;
+	}
+}
+
+void RenderQueue::Clear()
+{
+	m_Packets.clear();
+}
+
+/**
+ * LSD radix sort, 8 bits per pass. Passes where every key has the same byte are skipped,
+ * which is common since the high layer/shader bits rarely vary much within a frame.
+ */
+void RenderQueue::Sort()
+{
+	unsigned int count = (unsigned int)m_Sorted.size();
+	if (count < 2)
+		return;
+	m_Scratch.resize(count);
+
+	SortEntry* src = m_Sorted.data();
+	SortEntry* dst = m_Scratch.data();
+
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int histogram[256] = { 0 };
+		for (unsigned int i = 0; i < count; i++)
+			histogram[(src[i].Key >> shift) & 0xff]++;
+
+		if (histogram[(src[0].Key >> shift) & 0xff] == count)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int b = 0; b < 256; b++)
+		{
+			unsigned int n = histogram[b];
+			histogram[b] = offset;
+			offset += n;
+		}
+
+		for (unsigned int i = 0; i < count; i++)
+			dst[histogram[(src[i].Key >> shift) & 0xff]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != m_Sorted.data())
+		m_Sorted.swap(m_Scratch);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "Texture.h"
+
+/**
+ * Everything needed to issue one draw. Program is expected to follow the Basic shader
+ * conventions (u_MVP, u_Color, u_Texture on slot 0).
+ */
+struct DrawPacket
+{
+	uint64_t SortKey;
+	const VertexArray* Vao;
+	const IndexBuffer* Ibo;
+	Shader* Program;
+	const Texture* TextureMap;
+	glm::mat4 MVP;
+	glm::vec4 Color;
+};
+
+/**
+ * Collects draw packets for a frame, radix sorts them by their 64-bit key and executes
+ * them, only rebinding the program, vertex array, index buffer or texture when it
+ * actually changes from the previous packet.
+ *
+ * Key layout (most significant bit first):
+ *   opaque:      layer(4) | 0 | shader(10) | texture(12) | vao(12) | depth(24, front to back) | unused(1)
+ *   translucent: layer(4) | 1 | depth(24, back to front) | shader(10) | texture(12) | vao(12) | unused(1)
+ * Translucent packets therefore draw after all opaque ones of the same layer, and in
+ * depth order rather than state order so blending stays correct.
+ */
+class RenderQueue
+{
+public:
+	struct Stats
+	{
+		unsigned int DrawCalls;
+		unsigned int ProgramBinds;
+		unsigned int VertexArrayBinds;
+		unsigned int IndexBufferBinds;
+		unsigned int TextureBinds;
+	};
+private:
+	struct SortEntry
+	{
+		uint64_t Key;
+		unsigned int Index;
+	};
+
+	std::vector<DrawPacket> m_Packets;
+	std::vector<SortEntry> m_Sorted;
+	std::vector<SortEntry> m_Scratch;
+	bool m_SortEnabled;
+	Stats m_Stats;
+public:
+	RenderQueue();
+	~RenderQueue();
+
+	// depth is expected in [0, 1], 0 being closest to the camera
+	static uint64_t MakeSortKey(unsigned int layer, bool translucent, const Shader& shader,
+		const Texture* texture, const VertexArray& va, float depth);
+
+	void Submit(const DrawPacket& packet);
+	void Execute(const Renderer& renderer);
+	void Clear();
+
+	// Executing unsorted is only useful to measure what the sort buys us
+	inline void SetSortEnabled(bool enabled) { m_SortEnabled = enabled; }
+	inline bool IsSortEnabled() const { return m_SortEnabled; }
+	inline unsigned int GetPacketCount() const { return (unsigned int)m_Packets.size(); }
+	inline const Stats& GetStats() const { return m_Stats; }
+private:
+	void Sort();
+};
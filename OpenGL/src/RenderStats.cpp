@@ -0,0 +1,124 @@
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "GLState.h"
+
+#include "imgui/imgui.h"
+
+RenderStats::RenderStats()
+	: m_HistoryHead(0),
+	  m_HistoryCount(0)
+{
+	memset(m_Frame, 0, sizeof(m_Frame));
+	memset(m_History, 0, sizeof(m_History));
+}
+
+RenderStats& RenderStats::Get()
+{
+	static RenderStats stats;
+	return stats;
+}
+
+void RenderStats::AddDraw(unsigned int indexCount, unsigned int instanceCount /*= 1*/)
+{
+	m_Frame[DrawCalls]++;
+	m_Frame[Indices] += (uint64_t)indexCount * instanceCount;
+	m_Frame[Instances] += instanceCount;
+}
+
+void RenderStats::EndFrame()
+{
+	GLState& state = GLState::Current();
+	m_Frame[ProgramBinds] = state.GetCounters(GLState::Program).Issued;
+	m_Frame[VertexArrayBinds] = state.GetCounters(GLState::VertexArray).Issued;
+	m_Frame[TextureBinds] = state.GetCounters(GLState::Texture).Issued;
+
+	for (int i = 0; i < CounterCount; i++)
+		m_History[i][m_HistoryHead] = m_Frame[i];
+
+	m_HistoryHead = (m_HistoryHead + 1) % HistorySize;
+	m_HistoryCount = std::min(m_HistoryCount + 1, HistorySize);
+	memset(m_Frame, 0, sizeof(m_Frame));
+}
+
+void RenderStats::ResetHistory()
+{
+	m_HistoryHead = 0;
+	m_HistoryCount = 0;
+}
+
+RenderStats::Summary RenderStats::GetSummary(Counter counter) const
+{
+	Summary summary = { 0, 0, 0, 0.0 };
+	if (m_HistoryCount == 0)
+		return summary;
+
+	const uint64_t* history = m_History[counter];
+	summary.Last = history[(m_HistoryHead + HistorySize - 1) % HistorySize];
+	summary.Min = summary.Last;
+
+	uint64_t total = 0;
+	for (unsigned int i = 0; i < m_HistoryCount; i++)
+	{
+		uint64_t value = history[(m_HistoryHead + HistorySize - 1 - i) % HistorySize];
+		summary.Min = std::min(summary.Min, value);
+		summary.Max = std::max(summary.Max, value);
+		total += value;
+	}
+	summary.Average = (double)total / m_HistoryCount;
+	return summary;
+}
+
+const char* RenderStats::GetCounterName(Counter counter)
+{
+	switch (counter)
+	{
+	case DrawCalls:        return "Draw calls";
+	case Indices:          return "Indices";
+	case Instances:        return "Instances";
+	case ProgramBinds:     return "Program binds";
+	case VertexArrayBinds: return "VAO binds";
+	case TextureBinds:     return "Texture binds";
+	case UniformUpdates:   return "Uniform updates";
+	case BufferBytes:      return "Buffer KB";
+	case TextureBytes:     return "Texture KB";
+	case Visible:          return "Visible";
+	case Culled:           return "Culled";
+	default:               return "?";
+	}
+}
+
+void RenderStats::OnImGuiRender()
+{
+	// Pinned to the top right corner, see the "simple overlay" in the ImGui demo
+	const float margin = 10.0f;
+	ImGuiIO& io = ImGui::GetIO();
+	ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - margin, margin), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+	ImGui::SetNextWindowBgAlpha(0.35f);
+
+	ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings
+		| ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+	if (ImGui::Begin("Renderer Stats", nullptr, flags))
+	{
+		ImGui::Text("%-16s %8s %8s %10s %8s", "", "last", "min", "avg", "max");
+		ImGui::Separator();
+		for (int i = 0; i < CounterCount; i++)
+		{
+			Counter counter = (Counter)i;
+			Summary summary = GetSummary(counter);
+			if (counter == BufferBytes || counter == TextureBytes)
+			{
+				ImGui::Text("%-16s %8.1f %8.1f %10.1f %8.1f", GetCounterName(counter),
+					summary.Last / 1024.0, summary.Min / 1024.0, summary.Average / 1024.0, summary.Max / 1024.0);
+			}
+			else
+			{
+				ImGui::Text("%-16s %8llu %8llu %10.1f %8llu", GetCounterName(counter),
+					(unsigned long long)summary.Last, (unsigned long long)summary.Min, summary.Average, (unsigned long long)summary.Max);
+			}
+		}
+	}
+	ImGui::End();
+}
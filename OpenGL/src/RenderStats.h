@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Per-frame counters of the work we hand to GL, with a rolling history of the last
+ * HistorySize frames.
+ *
+ * Draws, uniform updates and uploads are counted where our wrappers issue them. Binds
+ * are taken from the GLState counters (issued calls only) when the frame ends, so call
+ * EndFrame() after the frame's draws and before GLState::ResetCounters(). Everything
+ * runs on the GL thread. Visible and Culled come from whoever culls, see CullingSet.
+ */
+class RenderStats
+{
+public:
+	enum Counter
+	{
+		DrawCalls,
+		Indices,
+		Instances,      // 1 per plain draw
+		ProgramBinds,
+		VertexArrayBinds,
+		TextureBinds,
+		UniformUpdates, // glUniform* calls and uniform buffer uploads
+		BufferBytes,    // vertex, index and uniform data
+		TextureBytes,
+		Visible,        // objects that passed culling
+		Culled,         // objects culling kept from being drawn
+		CounterCount
+	};
+
+	static const unsigned int HistorySize = 120;
+
+	struct Summary
+	{
+		uint64_t Last;
+		uint64_t Min;
+		uint64_t Max;
+		double Average;
+	};
+private:
+	uint64_t m_Frame[CounterCount];
+	uint64_t m_History[CounterCount][HistorySize];
+	unsigned int m_HistoryHead;  // next slot to write
+	unsigned int m_HistoryCount;
+public:
+	static RenderStats& Get();
+
+	inline void Add(Counter counter, uint64_t amount = 1) { m_Frame[counter] += amount; }
+	void AddDraw(unsigned int indexCount, unsigned int instanceCount = 1);
+
+	// Closes the frame: pushes its counters into the history and starts the next one at 0
+	void EndFrame();
+	void ResetHistory();
+
+	// The frame still being counted
+	inline uint64_t GetCurrent(Counter counter) const { return m_Frame[counter]; }
+	// Over the frames in the history, all zero before the first EndFrame()
+	Summary GetSummary(Counter counter) const;
+	inline unsigned int GetHistoryCount() const { return m_HistoryCount; }
+
+	static const char* GetCounterName(Counter counter);
+
+	// A small corner overlay with the last, min, avg and max of every counter
+	void OnImGuiRender();
+private:
+	RenderStats();
+};
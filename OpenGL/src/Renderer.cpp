@@ -1,15 +1,81 @@
 #include "Renderer.h"
 
+#include <cstring>
+
+#include "GpuProfiler.h"
+#include "RenderStats.h"
+#include "CpuProfiler.h"
+
+Renderer::Renderer()
+	: m_FrameProjectionOffset(m_FrameLayout.Push<glm::mat4>()),
+	  m_FrameViewOffset(m_FrameLayout.Push<glm::mat4>()),
+	  m_FrameTimeOffset(m_FrameLayout.Push<float>()),
+	  m_FrameStaging(m_FrameLayout.GetSize()),
+	  m_FrameUniforms(m_FrameLayout.GetSize()),
+	  m_Interpolation(1.0f)
+{
+	PROFILE_FUNCTION();
+	m_FrameUniforms.BindBase(FrameUniformBinding);
+}
+
+void Renderer::SetFrameData(const glm::mat4& projection, const glm::mat4& view, float time)
+{
+	PROFILE_FUNCTION();
+	memcpy(&m_FrameStaging[m_FrameProjectionOffset], &projection[0][0], sizeof(glm::mat4));
+	memcpy(&m_FrameStaging[m_FrameViewOffset], &view[0][0], sizeof(glm::mat4));
+	memcpy(&m_FrameStaging[m_FrameTimeOffset], &time, sizeof(float));
+
+	m_FrameUniforms.SetData(m_FrameStaging.data(), (unsigned int)m_FrameStaging.size());
+	m_FrameUniforms.BindBase(FrameUniformBinding);
+}
+
 void Renderer::Clear() const
 {
+	PROFILE_FUNCTION();
+	GpuScope scope("Clear");
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void Renderer::Draw(const VertexArray & va, const IndexBuffer & ib, const Shader & shader) const
 {
+	PROFILE_FUNCTION();
+	GpuScope scope("Draw");
 	shader.Bind();
 	va.Bind();
 	ib.Bind();
 
 	glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr);
+	RenderStats::Get().AddDraw(ib.GetCount());
+}
+
+void Renderer::Draw(const VertexArray & va, const IndexBuffer & ib, const Shader & shader, unsigned int indexCount, int baseVertex /*= 0*/) const
+{
+	PROFILE_FUNCTION();
+	GpuScope scope("Draw");
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, baseVertex);
+	RenderStats::Get().AddDraw(indexCount);
+}
+
+void Renderer::DrawIndexed(unsigned int indexCount) const
+{
+	PROFILE_FUNCTION();
+	GpuScope scope("Draw");
+	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+	RenderStats::Get().AddDraw(indexCount);
+}
+
+void Renderer::DrawInstanced(const VertexArray & va, const IndexBuffer & ib, const Shader & shader, unsigned int instanceCount) const
+{
+	PROFILE_FUNCTION();
+	GpuScope scope("DrawInstanced");
+	shader.Bind();
+	va.Bind();
+	ib.Bind();
+
+	glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount);
+	RenderStats::Get().AddDraw(ib.GetCount(), instanceCount);
 }
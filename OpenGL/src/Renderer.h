@@ -4,11 +4,44 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
+
+#include <vector>
 
 class Renderer
 {
 public:
+	// Uniform buffer binding points shared by every program (blocks "Frame" and "Object")
+	static const unsigned int FrameUniformBinding = 0;
+	static const unsigned int ObjectUniformBinding = 1;
+private:
+	UniformBufferLayout m_FrameLayout;
+	unsigned int m_FrameProjectionOffset;
+	unsigned int m_FrameViewOffset;
+	unsigned int m_FrameTimeOffset;
+	std::vector<unsigned char> m_FrameStaging;
+	UniformBuffer m_FrameUniforms;
+	float m_Interpolation;
+public:
+	Renderer();
+
+	// Uploads the per-frame block once, visible to all programs declaring
+	// `layout(std140) uniform Frame { mat4 u_Projection; mat4 u_View; float u_Time; };`
+	void SetFrameData(const glm::mat4& projection, const glm::mat4& view, float time);
+
+	// How far rendering is between the last fixed update and the next one (see FrameTimer),
+	// tests blend their previous and current state by it
+	inline void SetInterpolation(float alpha) { m_Interpolation = alpha; }
+	inline float GetInterpolation() const { return m_Interpolation; }
+
 	void Clear() const;
 	void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+	// Draws only the first `indexCount` indices of `ib` (e.g. a partially filled batch),
+	// `baseVertex` is added to every index (e.g. the offset of a streamed allocation)
+	void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex = 0) const;
+	// Draws with whatever shader, vertex array and index buffer are currently bound
+	void DrawIndexed(unsigned int indexCount) const;
+	// Draws `instanceCount` copies of the mesh, per-instance data comes from attributes with a divisor
+	void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
 };
 
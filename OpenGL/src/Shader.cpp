@@ -1,61 +1,175 @@
+#include <cerrno>
 #include <iostream>
-#include <fstream>
-#include <streambuf>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <alloca.h>
+#endif
 
 #include "Shader.h"
 #include "Renderer.h"
+#include "GLState.h"
+#include "ShaderCache.h"
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
+#include "RenderStats.h"
 
-Shader::Shader(const std::string & name)
-	: m_ShaderName(name), m_RendererID(0)
+bool Shader::s_ParallelCompileSupported = false;
+
+// Uniform blocks shared by all programs, see Renderer::SetFrameData
+static const struct
+{
+	const char* Name;
+	unsigned int Binding;
+} s_WellKnownUniformBlocks[] = {
+	{ "Frame",  Renderer::FrameUniformBinding },
+	{ "Object", Renderer::ObjectUniformBinding },
+};
+
+Shader::Shader(const std::string & name, const std::vector<std::string>& defines /*= {}*/,
+	ShaderCompileMode mode /*= ShaderCompileMode::Sync*/)
+	: m_ShaderName(name), m_Defines(defines), m_RendererID(0),
+	  m_Ready(false), m_PendingVertexShader(0), m_PendingFragmentShader(0), m_CacheKey(0),
+	  m_UniformCount(0)
 {
+	PROFILE_FUNCTION();
 	// TODO: work in constructor feels dirty
 	ShaderProgramSource source = ReadShaderSource();
-	m_RendererID = CreateShader(source);
+	BeginCreateShader(source);
+
+	if (mode == ShaderCompileMode::Sync)
+		WaitUntilReady();
 }
 
 
 Shader::~Shader()
 {
+	PROFILE_FUNCTION();
+	// Still compiling, the program never got to release them
+	if (m_PendingVertexShader)
+		glDeleteShader(m_PendingVertexShader);
+	if (m_PendingFragmentShader)
+		glDeleteShader(m_PendingFragmentShader);
+
+	GLState::Current().OnDeleteProgram(m_RendererID);
 	glDeleteProgram(m_RendererID);
 }
 
+void Shader::EnableParallelCompile()
+{
+	PROFILE_FUNCTION();
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsKHR(0xffffffff); // as many as the driver likes
+		s_ParallelCompileSupported = true;
+	}
+	else if (GLEW_ARB_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsARB(0xffffffff);
+		s_ParallelCompileSupported = true;
+	}
+}
+
+bool Shader::IsReady()
+{
+	PROFILE_FUNCTION();
+	if (m_Ready)
+		return true;
+
+	if (s_ParallelCompileSupported)
+	{
+		// Unlike GL_LINK_STATUS this query never waits for the compiler
+		int completed;
+		glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed == GL_FALSE)
+			return false;
+	}
+
+	FinishCreateShader();
+	return true;
+}
+
+void Shader::WaitUntilReady()
+{
+	PROFILE_FUNCTION();
+	if (!m_Ready)
+		FinishCreateShader();
+}
+
 void Shader::Bind() const
 {
-	glUseProgram(m_RendererID);
+	PROFILE_FUNCTION();
+	GLState::Current().UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-	glUseProgram(0);
+	PROFILE_FUNCTION();
+	GLState::Current().UseProgram(0);
 }
 
-void Shader::SetUniform1i(const std::string & name, int value)
+void Shader::SetUniform1i(UniformId id, int value)
 {
-	glUniform1i(GetUniformLocation(name), value);
+	PROFILE_FUNCTION();
+	glUniform1i(GetUniformLocation(id), value);
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
 }
 
-void Shader::SetUniform4f(const std::string & name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform1iv(UniformId id, int count, const int * values)
 {
-	glUniform4f(GetUniformLocation(name), v0, v1, v2, v3);
+	PROFILE_FUNCTION();
+	glUniform1iv(GetUniformLocation(id), count, values);
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
 }
 
-void Shader::SetUniformMatrix4f(const std::string & name, const glm::mat4 matrix)
+void Shader::SetUniform4f(UniformId id, float v0, float v1, float v2, float v3)
 {
-	glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
+	PROFILE_FUNCTION();
+	glUniform4f(GetUniformLocation(id), v0, v1, v2, v3);
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
 }
 
+void Shader::SetUniformMatrix4f(UniformId id, const glm::mat4& matrix)
+{
+	PROFILE_FUNCTION();
+	glUniformMatrix4fv(GetUniformLocation(id), 1, GL_FALSE, &matrix[0][0]);
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
+}
+
+
+void Shader::BindUniformBlock(const std::string & name, unsigned int binding)
+{
+	PROFILE_FUNCTION();
+	unsigned int index = glGetUniformBlockIndex(m_RendererID, name.c_str());
+	if (index == GL_INVALID_INDEX)
+	{
+		std::cout << "Warning: uniform block '" << name << "'"
+				  << ", requested in shader '" << m_ShaderName << "',"
+				  << " dosn't exist!";
+		return;
+	}
+
+	glUniformBlockBinding(m_RendererID, index, binding);
+}
+
+void Shader::BindWellKnownUniformBlocks()
+{
+	for (const auto& block : s_WellKnownUniformBlocks)
+	{
+		unsigned int index = glGetUniformBlockIndex(m_RendererID, block.Name);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(m_RendererID, index, block.Binding);
+	}
+}
 
 std::string Shader::ReadShaderFile(const std::string& shaderFile)
 {
-	std::ifstream in("res/shaders/" + shaderFile);
-	if (in)
+	AssetView file = AssetArchive::Read("res/shaders/" + shaderFile);
+	if (file.IsValid())
 	{
-		return (std::string(
-			(std::istreambuf_iterator<char>(in)), 
-			std::istreambuf_iterator<char>())
-		);
+		return std::string((const char*)file.GetData(), file.GetSize());
 	}
-	throw(errno);
+	throw(ENOENT);
 }
 
 ShaderProgramSource Shader::ReadShaderSource()
@@ -63,7 +177,29 @@ ShaderProgramSource Shader::ReadShaderSource()
 	std::string vShader = ReadShaderFile(m_ShaderName + ".vert");
 	std::string fShader = ReadShaderFile(m_ShaderName + ".frag");
 
-	return { vShader, fShader };
+	return { InjectDefines(vShader), InjectDefines(fShader) };
+}
+
+std::string Shader::InjectDefines(const std::string& source)
+{
+	if (m_Defines.empty())
+		return source;
+
+	std::string defines;
+	for (const std::string& define : m_Defines)
+		defines += "#define " + define + "\n";
+
+	// #version has to stay the first statement
+	size_t insertAt = 0;
+	if (source.compare(0, 8, "#version") == 0)
+	{
+		size_t endOfLine = source.find('\n');
+		insertAt = endOfLine == std::string::npos ? source.size() : endOfLine + 1;
+	}
+
+	std::string result = source;
+	result.insert(insertAt, defines);
+	return result;
 }
 
 unsigned int Shader::HandleCompileShaderError(unsigned int id, unsigned int type) {
@@ -89,6 +225,21 @@ unsigned int Shader::HandleCompileShaderError(unsigned int id, unsigned int type
 	return 0;
 }
 
+unsigned int Shader::HandleLinkProgramError(unsigned int program) {
+	int length;
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+
+	char* errorMessage = (char*)alloca(length * sizeof(char));
+	glGetProgramInfoLog(program, length, &length, errorMessage);
+
+	std::cout << "Failed to link shader '" << m_ShaderName << "'!" << std::endl;
+	std::cout << errorMessage << std::endl;
+
+	glDeleteProgram(program);
+
+	return 0;
+}
+
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
 	unsigned int id = glCreateShader(type);
@@ -96,49 +247,163 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 	glShaderSource(id, 1, &src, nullptr);
 	glCompileShader(id);
 
-	// Handle compile errors (syntax, et.c)
-	int result;
-	glGetShaderiv(id, GL_COMPILE_STATUS, &result);
-	if (result == GL_FALSE)
+	// Compile errors (syntax, et.c) are checked in FinishCreateShader, querying
+	// GL_COMPILE_STATUS here would wait for the compiler
+	return id;
+}
+
+void Shader::BeginCreateShader(const ShaderProgramSource& source)
+{
+	// Skip compiling entirely if the driver already gave us a binary for these sources
+	ShaderCache& cache = ShaderCache::Get();
+	if (cache.IsSupported())
 	{
-		return HandleCompileShaderError(id, type);
+		m_CacheKey = cache.MakeKey(source);
+		m_RendererID = cache.Load(m_CacheKey);
+		if (m_RendererID)
+		{
+			m_Ready = true;
+			BindWellKnownUniformBlocks();
+			ReflectUniforms();
+			return;
+		}
 	}
 
-	return id;
+	m_RendererID = glCreateProgram();
+	m_PendingVertexShader = CompileShader(GL_VERTEX_SHADER, source.Vertex);
+	m_PendingFragmentShader = CompileShader(GL_FRAGMENT_SHADER, source.Fragment);
+
+	glAttachShader(m_RendererID, m_PendingVertexShader);
+	glAttachShader(m_RendererID, m_PendingFragmentShader);
+	if (cache.IsSupported())
+		glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	// TODO: read up on these
+	glLinkProgram(m_RendererID);
 }
 
-unsigned int Shader::CreateShader(const ShaderProgramSource& source)
+void Shader::FinishCreateShader()
 {
-	unsigned int program = glCreateProgram();
-	unsigned int vs = CompileShader(GL_VERTEX_SHADER, source.Vertex);
-	unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, source.Fragment);
+	m_Ready = true;
 
-	glAttachShader(program, vs);
-	glAttachShader(program, fs);
-	// TODO: read up on these
-	glLinkProgram(program);
-	glValidateProgram(program);
+	int vsCompiled, fsCompiled;
+	glGetShaderiv(m_PendingVertexShader, GL_COMPILE_STATUS, &vsCompiled);
+	glGetShaderiv(m_PendingFragmentShader, GL_COMPILE_STATUS, &fsCompiled);
+
+	// Delete intermediate shaders now that they have been linked into the program,
+	// the error handler takes care of the ones that failed
+	if (vsCompiled == GL_FALSE)
+		HandleCompileShaderError(m_PendingVertexShader, GL_VERTEX_SHADER);
+	else
+		glDeleteShader(m_PendingVertexShader);
+
+	if (fsCompiled == GL_FALSE)
+		HandleCompileShaderError(m_PendingFragmentShader, GL_FRAGMENT_SHADER);
+	else
+		glDeleteShader(m_PendingFragmentShader);
+
+	m_PendingVertexShader = 0;
+	m_PendingFragmentShader = 0;
+
+	int linked;
+	glGetProgramiv(m_RendererID, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+	{
+		m_RendererID = HandleLinkProgramError(m_RendererID);
+		return;
+	}
 
-	// Delete intermediate shaders now that they have been linked into the program
-	glDeleteShader(vs);
-	glDeleteShader(fs);
+	glValidateProgram(m_RendererID);
+	BindWellKnownUniformBlocks();
+	ReflectUniforms();
 
-	return program;
+	ShaderCache& cache = ShaderCache::Get();
+	if (cache.IsSupported())
+		cache.Store(m_CacheKey, m_RendererID);
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+void Shader::ReflectUniforms()
 {
-	if (m_UniformLocationCache.find(name) == m_UniformLocationCache.end()) {
-		m_UniformLocationCache[name] = glGetUniformLocation(m_RendererID, name.c_str());
+	int count = 0, maxLength = 0;
+	glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
 
-		if (m_UniformLocationCache[name] == -1)
+	// Keep the load factor at or below 1/2 so probes stay short
+	unsigned int capacity = 16;
+	while (capacity < (unsigned int)count * 2)
+		capacity *= 2;
+	m_UniformTable.assign(capacity, { 0, EmptySlot });
+	m_UniformCount = 0;
+
+	std::vector<char> name(maxLength + 1);
+	for (int i = 0; i < count; i++)
+	{
+		int length, size;
+		GLenum type;
+		glGetActiveUniform(m_RendererID, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+
+		// Members of uniform blocks have no location
+		int location = glGetUniformLocation(m_RendererID, name.data());
+		if (location == -1)
+			continue;
+
+		// Arrays are reported as "name[0]", address them by their plain name
+		std::string uniformName(name.data(), length);
+		if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+			uniformName.resize(uniformName.size() - 3);
+
+		InsertUniform(UniformId::HashName(uniformName.c_str()), location);
+	}
+}
+
+void Shader::InsertUniform(uint32_t hash, int location)
+{
+	// Grow before the load factor goes past 1/2 (only happens for names that don't exist)
+	if ((m_UniformCount + 1) * 2 > m_UniformTable.size())
+	{
+		std::vector<UniformSlot> old;
+		old.swap(m_UniformTable);
+		m_UniformTable.assign(old.empty() ? 16 : old.size() * 2, { 0, EmptySlot });
+		m_UniformCount = 0;
+		for (const UniformSlot& slot : old)
 		{
-			std::cout << "Warning: uniform '" << name << "'"
-					  << ", requested in shader '" << m_ShaderName << "',"
-					  << " dosn't exist!";
+			if (slot.Location != EmptySlot)
+				InsertUniform(slot.Hash, slot.Location);
 		}
 	}
 
-	return m_UniformLocationCache[name];
+	unsigned int mask = (unsigned int)m_UniformTable.size() - 1;
+	unsigned int i = hash & mask;
+	while (m_UniformTable[i].Location != EmptySlot)
+	{
+		if (m_UniformTable[i].Hash == hash)
+		{
+			std::cout << "Warning: uniform hash collision in shader '" << m_ShaderName << "'" << std::endl;
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	m_UniformTable[i] = { hash, location };
+	m_UniformCount++;
 }
 
+int Shader::GetUniformLocation(UniformId id)
+{
+	if (!m_UniformTable.empty())
+	{
+		unsigned int mask = (unsigned int)m_UniformTable.size() - 1;
+		for (unsigned int i = id.Hash & mask; m_UniformTable[i].Location != EmptySlot; i = (i + 1) & mask)
+		{
+			if (m_UniformTable[i].Hash == id.Hash)
+				return m_UniformTable[i].Location;
+		}
+	}
+
+	// Remember the miss so we only warn once per name
+	std::cout << "Warning: uniform '" << id.Name << "'"
+			  << ", requested in shader '" << m_ShaderName << "',"
+			  << " dosn't exist!";
+	InsertUniform(id.Hash, -1);
+
+	return -1;
+}
@@ -2,8 +2,11 @@
 
 #include "glm/glm.hpp"
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+#include "UniformId.h"
 
 struct ShaderProgramSource
 {
@@ -11,29 +14,82 @@ struct ShaderProgramSource
 	std::string Fragment;
 };
 
+enum class ShaderCompileMode
+{
+	// Compile and link before the constructor returns
+	Sync,
+	// Kick off compile and link, poll IsReady() (e.g. once per frame) before using the shader
+	Async
+};
+
 class Shader
 {
 private:
 	std::string m_ShaderName;
+	std::vector<std::string> m_Defines;
 	unsigned int m_RendererID;
-	std::unordered_map<std::string, int> m_UniformLocationCache;
+
+	// In flight until FinishCreateShader
+	bool m_Ready;
+	unsigned int m_PendingVertexShader;
+	unsigned int m_PendingFragmentShader;
+	uint64_t m_CacheKey;
+
+	// Open addressing table (linear probing) from UniformId hash to location, filled by
+	// reflecting the program once it is linked. Its size is always a power of two
+	struct UniformSlot
+	{
+		uint32_t Hash;
+		int Location; // EmptySlot if unused, -1 for names we were asked for that don't exist
+	};
+	static const int EmptySlot = -2;
+	std::vector<UniformSlot> m_UniformTable;
+	unsigned int m_UniformCount;
+
+	static bool s_ParallelCompileSupported;
 public:
-	Shader(const std::string& shaderName);
+	// Every define is injected as `#define <define>` right after the #version line
+	Shader(const std::string& shaderName, const std::vector<std::string>& defines = {},
+		ShaderCompileMode mode = ShaderCompileMode::Sync);
 	~Shader();
 
+	// Lets the driver compile on background threads (KHR/ARB_parallel_shader_compile).
+	// Call once after the context is created
+	static void EnableParallelCompile();
+
+	// Never blocks when the driver supports parallel compile, finishes the program once it is done.
+	// Without the extension the first call finishes the program synchronously
+	bool IsReady();
+	void WaitUntilReady();
+	// False if compiling or linking failed
+	inline bool IsValid() const { return m_RendererID != 0; }
+
 	void Bind() const;
 	void Unbind() const;
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
 	// Set uniforms
-	void SetUniform1i(const std::string& name, int value);
-	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
-	void SetUniformMatrix4f(const std::string& name, const glm::mat4 matrix);
+	void SetUniform1i(UniformId id, int value);
+	void SetUniform1iv(UniformId id, int count, const int* values);
+	void SetUniform4f(UniformId id, float v0, float v1, float v2, float v3);
+	void SetUniformMatrix4f(UniformId id, const glm::mat4& matrix);
+
+	// Points the named uniform block at a UniformBuffer binding point. The blocks listed in
+	// Shader.cpp (Frame, Object) are bound automatically when the program is created
+	void BindUniformBlock(const std::string& name, unsigned int binding);
 private:
 	std::string ReadShaderFile(const std::string& shaderFile);
 	ShaderProgramSource ReadShaderSource();
+	std::string InjectDefines(const std::string& source);
 	unsigned int HandleCompileShaderError(unsigned int id, unsigned int type);
+	unsigned int HandleLinkProgramError(unsigned int program);
 	unsigned int CompileShader(unsigned int type, const std::string& source);
-	unsigned int CreateShader(const ShaderProgramSource& source);
-	int GetUniformLocation(const std::string& name);
+	void BeginCreateShader(const ShaderProgramSource& source);
+	void FinishCreateShader();
+	void BindWellKnownUniformBlocks();
+	void ReflectUniforms();
+	void InsertUniform(uint32_t hash, int location);
+	int GetUniformLocation(UniformId id);
 };
 
@@ -0,0 +1,187 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDirectory(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MakeDirectory(path) mkdir(path, 0755)
+#endif
+
+#include "Renderer.h"
+
+struct ShaderCacheHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Key;
+	uint64_t DriverHash;
+	uint32_t BinaryFormat;
+	uint32_t Length;
+};
+
+static const uint32_t s_Magic = 0x42504c47; // "GLPB"
+static const uint32_t s_Version = 1;
+
+ShaderCache& ShaderCache::Get()
+{
+	static ShaderCache cache;
+	return cache;
+}
+
+ShaderCache::ShaderCache()
+	: m_Directory("cache/shaders/"),
+	  m_Supported(false),
+	  m_DriverHash(0),
+	  m_Initialized(false)
+{
+}
+
+uint64_t ShaderCache::Hash(const void* data, size_t size, uint64_t seed /*= 0xcbf29ce484222325ull*/)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+void ShaderCache::Initialize()
+{
+	// Needs a current context, so done on first use rather than in the constructor
+	m_Initialized = true;
+
+	int formatCount = 0;
+	if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	m_Supported = formatCount > 0;
+
+	const char* strings[] = {
+		(const char*)glGetString(GL_VENDOR),
+		(const char*)glGetString(GL_RENDERER),
+		(const char*)glGetString(GL_VERSION)
+	};
+	m_DriverHash = Hash(nullptr, 0);
+	for (const char* str : strings)
+	{
+		if (str)
+			m_DriverHash = Hash(str, strlen(str), m_DriverHash);
+	}
+
+	if (m_Supported)
+	{
+		MakeDirectory("cache");
+		MakeDirectory(m_Directory.c_str());
+	}
+}
+
+bool ShaderCache::IsSupported()
+{
+	if (!m_Initialized)
+		Initialize();
+	return m_Supported;
+}
+
+uint64_t ShaderCache::MakeKey(const ShaderProgramSource& source)
+{
+	if (!m_Initialized)
+		Initialize();
+
+	// Each stage is prefixed with its length, otherwise moving text across the
+	// boundary between the stages would give the same key
+	uint64_t key = m_DriverHash;
+	for (const std::string* stage : { &source.Vertex, &source.Fragment })
+	{
+		uint64_t length = stage->size();
+		key = Hash(&length, sizeof(length), key);
+		key = Hash(stage->data(), stage->size(), key);
+	}
+	return key;
+}
+
+std::string ShaderCache::GetPath(uint64_t key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+	return m_Directory + name;
+}
+
+unsigned int ShaderCache::Load(uint64_t key)
+{
+	if (!IsSupported())
+		return 0;
+
+	std::string path = GetPath(key);
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in)
+		return 0;
+
+	std::streamoff fileSize = in.tellg();
+	in.seekg(0);
+
+	ShaderCacheHeader header;
+	std::vector<char> binary;
+	bool valid = fileSize >= (std::streamoff)sizeof(header) && in.read((char*)&header, sizeof(header))
+		&& header.Magic == s_Magic && header.Version == s_Version
+		&& header.Key == key && header.DriverHash == m_DriverHash
+		// Checked before allocating, a corrupt length must not turn into a huge resize
+		&& header.Length == (uint64_t)(fileSize - sizeof(header));
+	if (valid)
+	{
+		binary.resize(header.Length);
+		valid = (bool)in.read(binary.data(), header.Length);
+	}
+	in.close();
+
+	unsigned int program = 0;
+	if (valid)
+	{
+		program = glCreateProgram();
+		glProgramBinary(program, header.BinaryFormat, binary.data(), header.Length);
+
+		int linked;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		if (linked == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+
+	if (!program)
+	{
+		std::cout << "Warning: discarding stale shader binary '" << path << "'" << std::endl;
+		std::remove(path.c_str());
+	}
+	return program;
+}
+
+void ShaderCache::Store(uint64_t key, unsigned int program)
+{
+	if (!IsSupported())
+		return;
+
+	int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	ShaderCacheHeader header = { s_Magic, s_Version, key, m_DriverHash, format, (uint32_t)length };
+
+	std::ofstream out(GetPath(key), std::ios::binary | std::ios::trunc);
+	out.write((const char*)&header, sizeof(header));
+	out.write(binary.data(), length);
+}
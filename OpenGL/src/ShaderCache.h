@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Shader.h"
+
+/**
+ * On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary).
+ *
+ * Binaries are keyed on a hash of the final shader sources (defines included) and the
+ * GL vendor, renderer and version strings, so a driver update simply produces new keys.
+ * A binary the driver refuses to load is deleted and the program is rebuilt from source.
+ */
+class ShaderCache
+{
+private:
+	std::string m_Directory;
+	bool m_Supported;
+	uint64_t m_DriverHash;
+	bool m_Initialized;
+public:
+	static ShaderCache& Get();
+
+	// 64-bit FNV-1a
+	static uint64_t Hash(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+
+	bool IsSupported();
+	uint64_t MakeKey(const ShaderProgramSource& source);
+
+	// Returns a linked program, or 0 if there is no (usable) binary for the key
+	unsigned int Load(uint64_t key);
+	void Store(uint64_t key, unsigned int program);
+private:
+	ShaderCache();
+	void Initialize();
+	std::string GetPath(uint64_t key) const;
+};
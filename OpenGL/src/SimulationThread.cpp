@@ -0,0 +1,108 @@
+#include "SimulationThread.h"
+
+#include <chrono>
+
+#include "CpuProfiler.h"
+#include "FrameTimer.h"
+
+SimulationThread::SimulationThread()
+	: m_Test(nullptr),
+	  m_WindowX(0),
+	  m_WindowY(0),
+	  m_Running(false),
+	  m_HasFrame(false),
+	  m_UpdatesPerSecond(0)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+	Stop();
+}
+
+void SimulationThread::Start(test::Test* test, unsigned int windowX, unsigned int windowY)
+{
+	Stop();
+
+	m_Test = test;
+	m_WindowX = windowX;
+	m_WindowY = windowY;
+	m_Mailbox.Reset();
+	m_HasFrame = false;
+	m_Running = true;
+	m_Thread = std::thread(&SimulationThread::ThreadMain, this);
+}
+
+void SimulationThread::Stop()
+{
+	if (!m_Thread.joinable())
+		return;
+
+	m_Running = false;
+	m_Thread.join();
+	m_Test = nullptr;
+	m_UpdatesPerSecond = 0;
+}
+
+const FramePacket* SimulationThread::AcquireFrame()
+{
+	if (m_Mailbox.Acquire())
+		m_HasFrame = true;
+	return m_HasFrame ? &m_Mailbox.GetReadBuffer() : nullptr;
+}
+
+void SimulationThread::ThreadMain()
+{
+	CpuProfiler::SetThreadName("Simulation");
+
+	FrameTimer timer;
+	unsigned long long frame = 0;
+	float time = 0.0f;
+	unsigned int updates = 0;
+	double second = 0.0;
+
+	while (m_Running)
+	{
+		unsigned int steps = timer.Advance();
+
+		second += timer.GetFrameTime();
+		updates += steps;
+		if (second >= 1.0)
+		{
+			m_UpdatesPerSecond = updates;
+			updates = 0;
+			second -= 1.0;
+		}
+
+		// Nothing due yet, sleep until the next step instead of spinning
+		if (steps == 0)
+		{
+			double wait = (1.0 - timer.GetAlpha()) * timer.GetStep();
+			std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+			continue;
+		}
+
+		PROFILE_SCOPE("Simulate");
+		FramePacket& packet = m_Mailbox.GetWriteBuffer();
+		{
+			std::lock_guard<std::mutex> lock(m_TestMutex);
+			for (unsigned int i = 0; i < steps; i++)
+			{
+				PROFILE_SCOPE("Update");
+				m_Test->OnUpdate(timer.GetStep());
+				time += timer.GetStep();
+			}
+
+			// Built right after the last update, so there is nothing to interpolate
+			PROFILE_SCOPE("Build Frame");
+			packet.Clear();
+			packet.Frame = frame++;
+			packet.Time = time;
+			packet.Interpolation = 1.0f;
+			packet.WindowX = m_WindowX;
+			packet.WindowY = m_WindowY;
+			m_Test->OnBuildFrame(packet);
+		}
+		m_Mailbox.Publish();
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "FrameMailbox.h"
+#include "FramePacket.h"
+#include "tests/Test.h"
+
+/**
+ * Runs a test's OnUpdate and OnBuildFrame on their own thread at a fixed timestep, so
+ * simulating frame N+1 overlaps with the GL thread submitting frame N.
+ *
+ * Packets go through a FrameMailbox, the GL thread renders whatever was published last
+ * (again, if nothing new came in since) and never waits for the simulation. Only tests
+ * returning true from Test::HasFramePackets can run this way.
+ *
+ * The test is still shared with the GL thread for OnImGuiRender and OnRenderFrame: hold
+ * GetTestMutex() while changing test settings from the GL thread, the simulation holds it
+ * while updating and building.
+ */
+class SimulationThread
+{
+private:
+	test::Test* m_Test;
+	unsigned int m_WindowX, m_WindowY;
+
+	std::thread m_Thread;
+	std::atomic<bool> m_Running;
+	std::mutex m_TestMutex;
+	FrameMailbox<FramePacket> m_Mailbox;
+	bool m_HasFrame; // GL thread only
+
+	std::atomic<unsigned int> m_UpdatesPerSecond;
+public:
+	SimulationThread();
+	~SimulationThread();
+
+	// Starts simulating `test`, which must stay alive until Stop()
+	void Start(test::Test* test, unsigned int windowX, unsigned int windowY);
+	void Stop();
+
+	// GL thread: the newest packet, nullptr until the first one is published
+	const FramePacket* AcquireFrame();
+
+	inline bool IsRunning() const { return m_Running; }
+	inline std::mutex& GetTestMutex() { return m_TestMutex; }
+	inline unsigned int GetUpdatesPerSecond() const { return m_UpdatesPerSecond; }
+private:
+	void ThreadMain();
+};
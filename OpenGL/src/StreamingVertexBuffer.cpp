@@ -0,0 +1,128 @@
+#include "StreamingVertexBuffer.h"
+
+#include "Renderer.h"
+#include "GLState.h"
+#include "RenderStats.h"
+
+StreamingVertexBuffer::StreamingVertexBuffer(unsigned int regionSize)
+	: VertexBuffer(),
+	  m_RegionSize(regionSize),
+	  m_Persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage),
+	  m_MappedPtr(nullptr),
+	  m_NeedsOrphan(false),
+	  m_Region(0),
+	  m_Head(0)
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+		m_Fences[i] = nullptr;
+
+	GLState::Current().BindArrayBuffer(m_RendererID);
+	if (m_Persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, RegionCount * regionSize, nullptr, flags);
+		m_MappedPtr = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, RegionCount * regionSize, flags);
+		ASSERT(m_MappedPtr);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, regionSize, nullptr, GL_STREAM_DRAW);
+		m_Staging.resize(regionSize);
+	}
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+	for (unsigned int i = 0; i < RegionCount; i++)
+	{
+		if (m_Fences[i])
+			glDeleteSync(m_Fences[i]);
+	}
+
+	if (m_MappedPtr)
+	{
+		GLState::Current().BindArrayBuffer(m_RendererID);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+}
+
+StreamingVertexBuffer::Allocation StreamingVertexBuffer::Allocate(unsigned int size, unsigned int alignment /*= 4*/)
+{
+	ASSERT(size <= m_RegionSize);
+
+	unsigned int offset = (m_Head + alignment - 1) / alignment * alignment;
+	if (offset + size > m_RegionSize)
+	{
+		NextRegion();
+		offset = 0;
+	}
+	m_Head = offset + size;
+
+	if (m_Persistent)
+	{
+		unsigned int gpuOffset = m_Region * m_RegionSize + offset;
+		return { m_MappedPtr + gpuOffset, gpuOffset };
+	}
+
+	if (m_NeedsOrphan)
+	{
+		// Hand the old storage back to the driver instead of waiting for the GPU to finish with it
+		GLState::Current().BindArrayBuffer(m_RendererID);
+		glBufferData(GL_ARRAY_BUFFER, m_RegionSize, nullptr, GL_STREAM_DRAW);
+		m_NeedsOrphan = false;
+	}
+	return { m_Staging.data() + offset, offset };
+}
+
+void StreamingVertexBuffer::Commit(const Allocation& allocation, unsigned int size)
+{
+	// Counted either way, the bytes were written to GPU visible memory by the caller
+	RenderStats::Get().Add(RenderStats::BufferBytes, size);
+
+	if (m_Persistent)
+		return;
+
+	GLState::Current().BindArrayBuffer(m_RendererID);
+	glBufferSubData(GL_ARRAY_BUFFER, allocation.GpuOffset, size, allocation.CpuPtr);
+}
+
+void StreamingVertexBuffer::EndFrame()
+{
+	if (m_Head > 0)
+		NextRegion();
+}
+
+void StreamingVertexBuffer::NextRegion()
+{
+	m_Head = 0;
+
+	if (!m_Persistent)
+	{
+		m_NeedsOrphan = true;
+		return;
+	}
+
+	m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_Region = (m_Region + 1) % RegionCount;
+	WaitForRegion(m_Region);
+}
+
+void StreamingVertexBuffer::WaitForRegion(unsigned int region)
+{
+	GLsync fence = m_Fences[region];
+	if (!fence)
+		return;
+
+	// Only blocks if the GPU is still reading this region from RegionCount frames ago
+	GLbitfield flags = 0;
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fence, flags, 1000000); // 1ms
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+			break;
+		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	}
+
+	glDeleteSync(fence);
+	m_Fences[region] = nullptr;
+}
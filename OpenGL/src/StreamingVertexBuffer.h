@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "VertexBuffer.h"
+
+/**
+ * Vertex buffer for geometry that is rewritten every frame.
+ *
+ * The buffer is split into RegionCount regions that are cycled through like a ring. Each
+ * region is guarded by a fence, so the CPU only waits if it laps the GPU.
+ *
+ * With GL 4.4 / ARB_buffer_storage the whole buffer is persistently mapped and Allocate
+ * hands out pointers straight into GPU visible memory. On plain GL 3.3 it falls back to
+ * a single region that is orphaned (glBufferData(nullptr)) whenever it wraps around and
+ * filled through glBufferSubData from a CPU staging copy in Commit.
+ *
+ * Usage:
+ *   auto alloc = vb.Allocate(bytes, sizeof(Vertex));
+ *   memcpy(alloc.CpuPtr, vertices, bytes);
+ *   vb.Commit(alloc, bytes);
+ *   // draw with baseVertex = alloc.GpuOffset / sizeof(Vertex)
+ *   vb.EndFrame();
+ */
+class StreamingVertexBuffer : public VertexBuffer
+{
+public:
+	static const unsigned int RegionCount = 3;
+
+	struct Allocation
+	{
+		void* CpuPtr;
+		unsigned int GpuOffset; // byte offset from the start of the GL buffer
+	};
+private:
+	unsigned int m_RegionSize;
+	bool m_Persistent;
+
+	unsigned char* m_MappedPtr;           // persistent mode: the whole buffer, mapped once
+	std::vector<unsigned char> m_Staging; // orphan mode: CPU copy of the (single) region
+	bool m_NeedsOrphan;
+
+	GLsync m_Fences[RegionCount];
+	unsigned int m_Region;
+	unsigned int m_Head; // bytes used in the current region
+public:
+	StreamingVertexBuffer(unsigned int regionSize);
+	~StreamingVertexBuffer();
+
+	// Returns `size` bytes of writable memory whose GPU offset is a multiple of `alignment`
+	Allocation Allocate(unsigned int size, unsigned int alignment = 4);
+	// Makes the written bytes visible to GL. A no-op for persistent coherent mappings
+	void Commit(const Allocation& allocation, unsigned int size);
+	// Fences the current region and moves on to the next one
+	void EndFrame();
+
+	inline bool IsPersistent() const { return m_Persistent; }
+	inline unsigned int GetRegionSize() const { return m_RegionSize; }
+private:
+	void NextRegion();
+	void WaitForRegion(unsigned int region);
+};
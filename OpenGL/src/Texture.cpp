@@ -1,47 +1,251 @@
 #include "stb_image/stb_image.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
 #include "Texture.h"
+#include "TextureContainer.h"
+#include "MipGenerator.h"
+#include "GLState.h"
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
+#include "RenderStats.h"
 
-Texture::Texture(const std::string & path)
+Texture::Texture(const std::string & path, Mipmaps mipmaps /*= Mipmaps::Gpu*/)
 	: m_RendererID(0),
 	  m_FilePath(path), 
 	  m_LocalBuffer(nullptr),
 	  m_Width(0),
 	  m_Height(0),
-	  m_BPP(0)
+	  m_BPP(0),
+	  m_Levels(0),
+	  m_Resident(true),
+	  m_PixelBuffer(0)
 {
-	stbi_set_flip_vertically_on_load(1);
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
-
+	PROFILE_FUNCTION();
 	glGenTextures(1, &m_RendererID);
-	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D, m_RendererID);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	if (m_LocalBuffer)
+	if (IsCompressedImagePath(path))
+	{
+		LoadCompressed();
+	}
+	else
 	{
-		stbi_image_free(m_LocalBuffer);
+		AssetView file = AssetArchive::Read(path);
+		stbi_set_flip_vertically_on_load(1);
+		if (file.IsValid())
+			m_LocalBuffer = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &m_Width, &m_Height, &m_BPP, 4);
+		if (!m_LocalBuffer)
+			std::cout << "Warning: failed to load texture '" << path << "'" << std::endl;
+
+		Upload(m_LocalBuffer, mipmaps);
+
+		if (m_LocalBuffer)
+		{
+			stbi_image_free(m_LocalBuffer);
+		}
 	}
+
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D, 0);
+}
+
+Texture::Texture(int width, int height, const void * data, Mipmaps mipmaps /*= Mipmaps::None*/)
+	: m_RendererID(0),
+	  m_LocalBuffer(nullptr),
+	  m_Width(width),
+	  m_Height(height),
+	  m_BPP(4),
+	  m_Levels(0),
+	  m_Resident(true),
+	  m_PixelBuffer(0)
+{
+	PROFILE_FUNCTION();
+	glGenTextures(1, &m_RendererID);
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D, m_RendererID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	Upload((const unsigned char*)data, mipmaps);
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D, 0);
 }
 
 Texture::~Texture()
 {
+	PROFILE_FUNCTION();
+	GLState::Current().OnDeleteTexture(m_RendererID);
 	glDeleteTextures(1, &m_RendererID);
+
+	if (m_PixelBuffer)
+		glDeleteBuffers(1, &m_PixelBuffer);
+}
+
+void Texture::Upload(const unsigned char* pixels, Mipmaps mipmaps)
+{
+	// Failed to load, leave it empty
+	if (m_Width <= 0 || m_Height <= 0)
+		return;
+
+	// Nothing to filter on the CPU yet, let GenerateMipmaps() do it once there is
+	if (!pixels && (mipmaps == Mipmaps::Cpu || mipmaps == Mipmaps::CpuLinear))
+		mipmaps = Mipmaps::Gpu;
+
+	if (mipmaps == Mipmaps::Cpu || mipmaps == Mipmaps::CpuLinear)
+	{
+		MipChain chain = GenerateMipChain(pixels, m_Width, m_Height, mipmaps == Mipmaps::Cpu);
+		m_Levels = (int)chain.Levels.size();
+		AllocateStorage(m_Levels, m_Width, m_Height);
+
+		for (size_t i = 0; i < chain.Levels.size(); i++)
+		{
+			const MipLevel& level = chain.Levels[i];
+			glTexSubImage2D(GL_TEXTURE_2D, (int)i, 0, 0, level.Width, level.Height, GL_RGBA, GL_UNSIGNED_BYTE, chain.GetLevelData(i));
+		}
+		RenderStats::Get().Add(RenderStats::TextureBytes, chain.Data.size());
+	}
+	else
+	{
+		m_Levels = mipmaps == Mipmaps::Gpu ? GetMipLevelCount(m_Width, m_Height) : 1;
+		AllocateStorage(m_Levels, m_Width, m_Height);
+
+		if (pixels)
+		{
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			RenderStats::Get().Add(RenderStats::TextureBytes, m_Width * m_Height * 4);
+			if (mipmaps == Mipmaps::Gpu)
+				glGenerateMipmap(GL_TEXTURE_2D);
+		}
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps == Mipmaps::None ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+}
+
+void Texture::LoadCompressed()
+{
+	CompressedImage image;
+	if (!LoadCompressedImage(m_FilePath, image))
+		return;
+
+	if (!image.IsSupported())
+	{
+		std::cout << "Warning: this GPU can't sample the compressed format of '" << m_FilePath << "'" << std::endl;
+		return;
+	}
+
+	m_Width = image.Width;
+	m_Height = image.Height;
+	m_BPP = 4;
+
+	m_Levels = (int)image.Levels.size();
+
+	// The blocks go straight to the GPU, mip chain and all
+	bool immutable = HasImmutableStorage();
+	if (immutable)
+		glTexStorage2D(GL_TEXTURE_2D, m_Levels, image.GetInternalFormat(), m_Width, m_Height);
+
+	for (size_t i = 0; i < image.Levels.size(); i++)
+	{
+		const CompressedLevel& level = image.Levels[i];
+		const unsigned char* data = image.Data.data() + level.Offset;
+		if (immutable)
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, (int)i, 0, 0, level.Width, level.Height, image.GetInternalFormat(), level.Size, data);
+		else
+			glCompressedTexImage2D(GL_TEXTURE_2D, (int)i, image.GetInternalFormat(), level.Width, level.Height, 0, level.Size, data);
+	}
+	RenderStats::Get().Add(RenderStats::TextureBytes, image.Data.size());
+
+	if (!immutable)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_Levels - 1);
+	if (image.Levels.size() > 1)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+bool Texture::HasImmutableStorage()
+{
+	return GLEW_VERSION_4_2 || GLEW_ARB_texture_storage;
+}
+
+void Texture::AllocateStorage(int levels, int width, int height)
+{
+	if (HasImmutableStorage())
+	{
+		glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+		return;
+	}
+
+	for (int level = 0; level < levels; level++)
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, std::max(1, width >> level), std::max(1, height >> level), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+}
+
+void Texture::Update(int x, int y, int width, int height, const void* data, bool viaPixelBuffer /*= false*/)
+{
+	PROFILE_FUNCTION();
+	GLState& state = GLState::Current();
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D, m_RendererID);
+
+	unsigned int size = width * height * 4;
+	void* dst = nullptr;
+	if (viaPixelBuffer)
+	{
+		if (!m_PixelBuffer)
+			glGenBuffers(1, &m_PixelBuffer);
+
+		// Orphaning hands us fresh memory if the last transfer is still in flight
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (!dst)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	if (dst)
+	{
+		memcpy(dst, data, size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	else
+	{
+		// Also taken when the pixel buffer could not be mapped
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+	RenderStats::Get().Add(RenderStats::TextureBytes, width * height * 4);
+
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D, 0);
+}
+
+void Texture::GenerateMipmaps()
+{
+	PROFILE_FUNCTION();
+	if (m_Levels < 2)
+		return;
+
+	GLState& state = GLState::Current();
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D, m_RendererID);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D, 0);
 }
 
 void Texture::Bind(unsigned int slot /*= 0*/) const
 {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+	PROFILE_FUNCTION();
+	GLState::Current().BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
 }
 
 void Texture::Unbind() const
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	PROFILE_FUNCTION();
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D, 0);
 }
@@ -2,21 +2,57 @@
 
 #include "Renderer.h"
 
+// How a texture gets its mip chain
+enum class Mipmaps
+{
+	None,      // a single level, sampled with GL_LINEAR
+	Gpu,       // glGenerateMipmap, whatever filter the driver uses
+	Cpu,       // box filtered on the CPU, color averaged in linear light (for sRGB encoded images)
+	CpuLinear  // box filtered on the CPU as is (for data that isn't color, e.g. normal maps)
+};
+
 class Texture
 {
+	// Swaps the placeholder for the real texture once it is uploaded
+	friend class TextureLoader;
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	int m_Levels;
+	bool m_Resident;
+	unsigned int m_PixelBuffer; // created on the first Update() that asks for it
 public:
-	Texture(const std::string& path);
+	// Loads a PNG/JPG/etc. (decoded with stb_image) or a pre-compressed .dds/.ktx2 file
+	Texture(const std::string& path, Mipmaps mipmaps = Mipmaps::Gpu);
+	// Creates a texture from raw RGBA8 pixels (e.g. a 1x1 white texture for untextured quads)
+	Texture(int width, int height, const void* data, Mipmaps mipmaps = Mipmaps::None);
 	~Texture();
 
 	void Bind(unsigned int slot = 0) const;
 	void Unbind() const;
 
+	// Replaces a width x height rectangle of level 0 with RGBA8 pixels, without
+	// reallocating the texture. With viaPixelBuffer the pixels go through a pixel
+	// buffer object, so the transfer to the GPU can happen after the call returns
+	void Update(int x, int y, int width, int height, const void* data, bool viaPixelBuffer = false);
+	// Rebuilds the smaller levels from level 0, e.g. after an Update()
+	void GenerateMipmaps();
+
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline int GetLevelCount() const { return m_Levels; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	// False while a TextureLoader is still streaming the image in, a placeholder is bound meanwhile
+	inline bool IsResident() const { return m_Resident; }
+private:
+	void Upload(const unsigned char* pixels, Mipmaps mipmaps);
+	void LoadCompressed();
+
+	static bool HasImmutableStorage();
+	// Allocates every level of the bound GL_TEXTURE_2D at once, immutable
+	// (glTexStorage2D) when the driver supports it so it never has to revalidate
+	static void AllocateStorage(int levels, int width, int height);
 };
 
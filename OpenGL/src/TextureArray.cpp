@@ -0,0 +1,114 @@
+#include "TextureArray.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "stb_image/stb_image.h"
+
+#include "AssetArchive.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include "MipGenerator.h"
+
+TextureArray::TextureArray(int width, int height, int layers, Mipmaps mipmaps /*= Mipmaps::Cpu*/)
+	: m_RendererID(0),
+	  m_Width(width),
+	  m_Height(height),
+	  m_Layers(layers),
+	  m_Levels(mipmaps == Mipmaps::None ? 1 : GetMipLevelCount(width, height)),
+	  m_Mipmaps(mipmaps)
+{
+	GLState& state = GLState::Current();
+
+	glGenTextures(1, &m_RendererID);
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, mipmaps == Mipmaps::None ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage)
+	{
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_Levels, GL_RGBA8, width, height, layers);
+	}
+	else
+	{
+		// Same layout by hand, the driver just can't assume it never changes
+		for (int level = 0; level < m_Levels; level++)
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, width >> level), std::max(1, height >> level), layers,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_Levels - 1);
+	}
+
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureArray::~TextureArray()
+{
+	GLState::Current().OnDeleteTexture(m_RendererID);
+	glDeleteTextures(1, &m_RendererID);
+}
+
+void TextureArray::SetLayer(int layer, const void* data)
+{
+	GLState& state = GLState::Current();
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+	if (m_Mipmaps == Mipmaps::Cpu || m_Mipmaps == Mipmaps::CpuLinear)
+	{
+		MipChain chain = GenerateMipChain((const unsigned char*)data, m_Width, m_Height, m_Mipmaps == Mipmaps::Cpu);
+		for (size_t i = 0; i < chain.Levels.size(); i++)
+		{
+			const MipLevel& level = chain.Levels[i];
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (int)i, 0, 0, layer, level.Width, level.Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, chain.GetLevelData(i));
+		}
+		RenderStats::Get().Add(RenderStats::TextureBytes, chain.Data.size());
+	}
+	else
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		RenderStats::Get().Add(RenderStats::TextureBytes, m_Width * m_Height * 4);
+	}
+
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, 0);
+}
+
+bool TextureArray::LoadLayer(int layer, const std::string& path)
+{
+	AssetView file = AssetArchive::Read(path);
+
+	int width, height, bpp;
+	unsigned char* pixels = nullptr;
+	stbi_set_flip_vertically_on_load(1);
+	if (file.IsValid())
+		pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &bpp, 4);
+
+	bool fits = pixels && width == m_Width && height == m_Height;
+	if (fits)
+		SetLayer(layer, pixels);
+	else
+		std::cout << "Warning: '" << path << "' can't go in a " << m_Width << "x" << m_Height << " texture array" << std::endl;
+
+	if (pixels)
+		stbi_image_free(pixels);
+	return fits;
+}
+
+void TextureArray::GenerateMipmaps()
+{
+	GLState& state = GLState::Current();
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, m_RendererID);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	state.BindTexture(state.GetActiveTexture(), GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::Bind(unsigned int slot /*= 0*/) const
+{
+	GLState::Current().BindTexture(slot, GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
+
+void TextureArray::Unbind() const
+{
+	GLState::Current().BindTexture(GLState::Current().GetActiveTexture(), GL_TEXTURE_2D_ARRAY, 0);
+}
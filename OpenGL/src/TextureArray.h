@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "Texture.h"
+
+/**
+ * A GL_TEXTURE_2D_ARRAY: many same-sized RGBA8 images behind one binding, picked in
+ * the shader by layer index (see the BasicArray shader). Switching image is then a
+ * vertex attribute change instead of a texture bind.
+ *
+ * Storage is allocated once up front (immutable with glTexStorage3D where available),
+ * layers are filled in afterwards with SetLayer/LoadLayer.
+ */
+class TextureArray
+{
+private:
+	unsigned int m_RendererID;
+	int m_Width, m_Height, m_Layers;
+	int m_Levels;
+	Mipmaps m_Mipmaps;
+public:
+	TextureArray(int width, int height, int layers, Mipmaps mipmaps = Mipmaps::Cpu);
+	~TextureArray();
+
+	// Uploads width x height RGBA8 pixels (row 0 at the bottom) into a layer,
+	// along with its mip chain for Mipmaps::Cpu/CpuLinear
+	void SetLayer(int layer, const void* data);
+	// The image has to match the array's size, returns false if it doesn't or can't be loaded
+	bool LoadLayer(int layer, const std::string& path);
+	// For Mipmaps::Gpu, call once the layers are filled in
+	void GenerateMipmaps();
+
+	void Bind(unsigned int slot = 0) const;
+	void Unbind() const;
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline int GetLayerCount() const { return m_Layers; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+};
@@ -0,0 +1,125 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "stb_image/stb_image.h"
+
+#include "AssetArchive.h"
+
+// imgui_draw.cpp compiles its own private copy of the packer, this is ours
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+TextureAtlas::TextureAtlas(int pageWidth /*= 2048*/, int pageHeight /*= 2048*/, int padding /*= 2*/)
+	: m_PageWidth(pageWidth),
+	  m_PageHeight(pageHeight),
+	  m_Padding(padding)
+{
+}
+
+int TextureAtlas::Add(const std::string& path)
+{
+	AssetView file = AssetArchive::Read(path);
+
+	int width, height, bpp;
+	unsigned char* pixels = nullptr;
+	stbi_set_flip_vertically_on_load(1);
+	if (file.IsValid())
+		pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &bpp, 4);
+	if (!pixels)
+	{
+		std::cout << "Warning: failed to load atlas image '" << path << "'" << std::endl;
+		return -1;
+	}
+
+	int id = Add(path, width, height, pixels);
+	stbi_image_free(pixels);
+	return id;
+}
+
+int TextureAtlas::Add(const std::string& name, int width, int height, const unsigned char* rgba)
+{
+	int id = (int)m_Regions.size();
+	m_Images.push_back({ name, width, height, std::vector<unsigned char>(rgba, rgba + width * height * 4) });
+	m_Regions.push_back({ glm::vec4(0.0f), width, height });
+	m_Names[name] = id;
+	return id;
+}
+
+int TextureAtlas::Find(const std::string& name) const
+{
+	auto it = m_Names.find(name);
+	return it != m_Names.end() ? it->second : -1;
+}
+
+bool TextureAtlas::Build(Mipmaps mipmaps /*= Mipmaps::None*/)
+{
+	std::vector<stbrp_rect> rects(m_Images.size());
+	for (size_t i = 0; i < m_Images.size(); i++)
+	{
+		rects[i].id = (int)i;
+		rects[i].w = (stbrp_coord)(m_Images[i].Width + m_Padding * 2);
+		rects[i].h = (stbrp_coord)(m_Images[i].Height + m_Padding * 2);
+	}
+
+	// One node per column of the page gives the packer its best results
+	std::vector<stbrp_node> nodes(m_PageWidth);
+	stbrp_context context;
+	stbrp_init_target(&context, m_PageWidth, m_PageHeight, nodes.data(), (int)nodes.size());
+	bool packed = stbrp_pack_rects(&context, rects.data(), (int)rects.size()) != 0;
+
+	std::vector<unsigned char> page(m_PageWidth * m_PageHeight * 4, 0);
+	int rowSize = m_PageWidth * 4;
+
+	for (const stbrp_rect& rect : rects)
+	{
+		const Image& image = m_Images[rect.id];
+		Region& region = m_Regions[rect.id];
+
+		if (!rect.was_packed)
+		{
+			std::cout << "Warning: atlas image '" << image.Name << "' didn't fit in the " << m_PageWidth << "x" << m_PageHeight << " page" << std::endl;
+			region.UV = glm::vec4(0.0f);
+			continue;
+		}
+
+		int x = rect.x + m_Padding;
+		int y = rect.y + m_Padding;
+
+		// Copy each row, repeating its first and last pixel out into the padding
+		for (int row = 0; row < image.Height; row++)
+		{
+			const unsigned char* src = image.Pixels.data() + row * image.Width * 4;
+			unsigned char* dst = page.data() + (y + row) * rowSize + x * 4;
+
+			memcpy(dst, src, image.Width * 4);
+			for (int p = 1; p <= m_Padding; p++)
+			{
+				memcpy(dst - p * 4, src, 4);
+				memcpy(dst + (image.Width - 1 + p) * 4, src + (image.Width - 1) * 4, 4);
+			}
+		}
+
+		// Then the first and last (already extruded) rows out above and below
+		int paddedRow = (image.Width + m_Padding * 2) * 4;
+		unsigned char* first = page.data() + y * rowSize + rect.x * 4;
+		unsigned char* last = page.data() + (y + image.Height - 1) * rowSize + rect.x * 4;
+		for (int p = 1; p <= m_Padding; p++)
+		{
+			memcpy(first - p * rowSize, first, paddedRow);
+			memcpy(last + p * rowSize, last, paddedRow);
+		}
+
+		region.UV = glm::vec4(
+			(float)x / m_PageWidth,
+			(float)y / m_PageHeight,
+			(float)(x + image.Width) / m_PageWidth,
+			(float)(y + image.Height) / m_PageHeight);
+	}
+
+	m_Page.reset(new Texture(m_PageWidth, m_PageHeight, page.data(), mipmaps));
+	return packed;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Texture.h"
+
+/**
+ * Packs many small images into one texture page so sprites drawn with different
+ * images can still share a texture binding (and a BatchRenderer batch).
+ *
+ * Add() images, then Build() packs them with the skyline packer from imstb_rectpack,
+ * uploads the page and hands out each image's UV rect, ready for
+ * BatchRenderer::SubmitQuad. Each image gets `padding` pixels of its own edge
+ * repeated around it, so bilinear filtering never picks up a neighbour's texels.
+ */
+class TextureAtlas
+{
+public:
+	struct Region
+	{
+		glm::vec4 UV; // (u0, v0, u1, v1)
+		int Width, Height;
+	};
+private:
+	struct Image
+	{
+		std::string Name;
+		int Width, Height;
+		std::vector<unsigned char> Pixels; // RGBA8, kept so the atlas can be rebuilt
+	};
+
+	int m_PageWidth, m_PageHeight;
+	int m_Padding;
+	std::vector<Image> m_Images;
+	std::vector<Region> m_Regions;
+	std::unordered_map<std::string, int> m_Names;
+	std::unique_ptr<Texture> m_Page;
+public:
+	TextureAtlas(int pageWidth = 2048, int pageHeight = 2048, int padding = 2);
+
+	// Returns the image's id, or -1 if it couldn't be loaded. Images are flipped
+	// like Texture flips them
+	int Add(const std::string& path);
+	// Adds raw RGBA8 pixels, row 0 at the bottom
+	int Add(const std::string& name, int width, int height, const unsigned char* rgba);
+
+	// Packs and uploads everything added so far, replacing any previous page. Images
+	// that didn't fit get an empty region, in which case this returns false
+	bool Build(Mipmaps mipmaps = Mipmaps::None);
+
+	inline const Region& GetRegion(int id) const { return m_Regions[id]; }
+	// -1 if there is no image by that name (its path, for images added by path)
+	int Find(const std::string& name) const;
+	inline int GetImageCount() const { return (int)m_Regions.size(); }
+
+	// Null until Build()
+	inline const Texture* GetTexture() const { return m_Page.get(); }
+};
@@ -0,0 +1,476 @@
+#include "TextureContainer.h"
+
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+	struct FormatInfo
+	{
+		CompressedFormat Format;
+		GLenum GLLinear, GLSrgb;
+		uint32_t FourCC;
+		uint32_t DxgiLinear, DxgiSrgb;
+		uint32_t VkLinear, VkSrgb;
+		uint8_t DfdModel;
+	};
+
+	inline constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+	}
+
+	// 0 where the container has no way to express the format
+	const FormatInfo s_Formats[] = {
+		{ CompressedFormat::BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, MakeFourCC('D', 'X', 'T', '1'), 71, 72, 133, 134, 128 },
+		{ CompressedFormat::BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, MakeFourCC('D', 'X', 'T', '3'), 74, 75, 135, 136, 129 },
+		{ CompressedFormat::BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, MakeFourCC('D', 'X', 'T', '5'), 77, 78, 137, 138, 130 },
+		{ CompressedFormat::BC4, GL_COMPRESSED_RED_RGTC1, 0, MakeFourCC('A', 'T', 'I', '1'), 80, 0, 139, 0, 131 },
+		{ CompressedFormat::BC5, GL_COMPRESSED_RG_RGTC2, 0, MakeFourCC('A', 'T', 'I', '2'), 83, 0, 141, 0, 132 },
+		{ CompressedFormat::BC7, GL_COMPRESSED_RGBA_BPTC_UNORM, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 0, 98, 99, 145, 146, 134 },
+		{ CompressedFormat::ETC2_RGB, GL_COMPRESSED_RGB8_ETC2, GL_COMPRESSED_SRGB8_ETC2, 0, 0, 0, 147, 148, 161 },
+		{ CompressedFormat::ETC2_RGBA, GL_COMPRESSED_RGBA8_ETC2_EAC, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, 0, 0, 0, 151, 152, 161 },
+	};
+
+	const FormatInfo* FindFormat(CompressedFormat format)
+	{
+		for (const FormatInfo& info : s_Formats)
+			if (info.Format == format)
+				return &info;
+		return nullptr;
+	}
+
+	// DDS header layout, offsets from the start of the file
+	const uint32_t DDSMagic = MakeFourCC('D', 'D', 'S', ' ');
+	const unsigned int DDSHeaderSize = 4 + 124;
+	const unsigned int DDSHeaderDX10Size = 20;
+	const uint32_t DDSCubemap = 0x200;
+
+	const uint8_t KTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+	const unsigned int KTX2HeaderSize = 80;
+	const unsigned int KTX2LevelIndexSize = 24;
+
+	// Containers are little endian, as is everything we run on
+	inline uint32_t Read32(const unsigned char* file, size_t offset)
+	{
+		uint32_t value;
+		memcpy(&value, file + offset, sizeof(value));
+		return value;
+	}
+
+	inline uint64_t Read64(const unsigned char* file, size_t offset)
+	{
+		uint64_t value;
+		memcpy(&value, file + offset, sizeof(value));
+		return value;
+	}
+
+	inline void Write8(std::vector<unsigned char>& out, uint8_t value) { out.push_back(value); }
+	inline void Write16(std::vector<unsigned char>& out, uint16_t value) { out.insert(out.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value)); }
+	inline void Write32(std::vector<unsigned char>& out, uint32_t value) { out.insert(out.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value)); }
+	inline void Write64(std::vector<unsigned char>& out, uint64_t value) { out.insert(out.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value)); }
+
+	std::string GetExtension(const std::string& path)
+	{
+		std::string extension = path.substr(path.find_last_of('.') + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		return extension;
+	}
+
+	// Levels down to 1x1, anything a header claims beyond that is bogus
+	unsigned int GetFullChainLevelCount(int width, int height)
+	{
+		unsigned int levelCount = 1;
+		while (std::max(width, height) >> levelCount)
+			levelCount++;
+		return levelCount;
+	}
+
+	// Fills in the level table, checking that the data really is there.
+	// Sizes come straight from the header, so the sums are done in 64 bits
+	bool SetupLevels(CompressedImage& image, unsigned int levelCount, size_t dataOffset, size_t dataSize)
+	{
+		uint64_t available = dataOffset <= dataSize ? dataSize - dataOffset : 0;
+		available = std::min<uint64_t>(available, UINT32_MAX);
+
+		uint64_t offset = 0;
+		for (unsigned int i = 0; i < levelCount; i++)
+		{
+			int width = std::max(1, image.Width >> i);
+			int height = std::max(1, image.Height >> i);
+			uint64_t size = CompressedImage::GetLevelSize(image.Format, width, height);
+			if (size > available - offset)
+				return false;
+
+			image.Levels.push_back({ width, height, (unsigned int)offset, (unsigned int)size });
+			offset += size;
+		}
+		return true;
+	}
+}
+
+GLenum CompressedImage::GetInternalFormat() const
+{
+	const FormatInfo* info = FindFormat(Format);
+	if (!info)
+		return 0;
+	return Srgb && info->GLSrgb ? info->GLSrgb : info->GLLinear;
+}
+
+bool CompressedImage::IsSupported() const
+{
+	switch (Format)
+	{
+	case CompressedFormat::BC1:
+	case CompressedFormat::BC2:
+	case CompressedFormat::BC3:
+		return GLEW_EXT_texture_compression_s3tc != 0;
+	case CompressedFormat::BC4:
+	case CompressedFormat::BC5:
+		return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+	case CompressedFormat::BC7:
+		return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+	case CompressedFormat::ETC2_RGB:
+	case CompressedFormat::ETC2_RGBA:
+		return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+	default:
+		return false;
+	}
+}
+
+unsigned int CompressedImage::GetBlockSize(CompressedFormat format)
+{
+	switch (format)
+	{
+	case CompressedFormat::BC1:
+	case CompressedFormat::BC4:
+	case CompressedFormat::ETC2_RGB:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+uint64_t CompressedImage::GetLevelSize(CompressedFormat format, int width, int height)
+{
+	return ((uint64_t)width + 3) / 4 * (((uint64_t)height + 3) / 4) * GetBlockSize(format);
+}
+
+bool IsCompressedImagePath(const std::string& path)
+{
+	std::string extension = GetExtension(path);
+	return extension == "dds" || extension == "ktx2";
+}
+
+bool LoadCompressedImage(const std::string& path, CompressedImage& image)
+{
+	AssetView file = AssetArchive::Read(path);
+	if (!file.IsValid())
+	{
+		std::cout << "Warning: could not open compressed texture '" << path << "'" << std::endl;
+		return false;
+	}
+
+	bool loaded = GetExtension(path) == "dds"
+		? LoadDDS(file.GetData(), file.GetSize(), image)
+		: LoadKTX2(file.GetData(), file.GetSize(), image);
+
+	if (!loaded)
+		std::cout << "Warning: '" << path << "' is not a 2D texture in a format we can read" << std::endl;
+	return loaded;
+}
+
+bool LoadDDS(const unsigned char* file, size_t size, CompressedImage& image)
+{
+	if (size < DDSHeaderSize || Read32(file, 0) != DDSMagic)
+		return false;
+
+	image.Height = (int)Read32(file, 12);
+	image.Width = (int)Read32(file, 16);
+	unsigned int levelCount = Read32(file, 28);
+	uint32_t fourCC = Read32(file, 84);
+	uint32_t caps2 = Read32(file, 112);
+
+	if (caps2 & DDSCubemap)
+		return false;
+
+	size_t dataOffset = DDSHeaderSize;
+	image.Format = CompressedFormat::Unknown;
+
+	if (fourCC == MakeFourCC('D', 'X', '1', '0'))
+	{
+		if (size < DDSHeaderSize + DDSHeaderDX10Size)
+			return false;
+
+		uint32_t dxgiFormat = Read32(file, DDSHeaderSize);
+		uint32_t arraySize = Read32(file, DDSHeaderSize + 12);
+		if (arraySize > 1)
+			return false;
+
+		for (const FormatInfo& info : s_Formats)
+		{
+			if (info.DxgiLinear && dxgiFormat == info.DxgiLinear)
+				image.Format = info.Format, image.Srgb = false;
+			else if (info.DxgiSrgb && dxgiFormat == info.DxgiSrgb)
+				image.Format = info.Format, image.Srgb = true;
+		}
+		dataOffset += DDSHeaderDX10Size;
+	}
+	else
+	{
+		// A couple of alternative spellings are common for the RGTC formats
+		if (fourCC == MakeFourCC('B', 'C', '4', 'U'))
+			fourCC = MakeFourCC('A', 'T', 'I', '1');
+		else if (fourCC == MakeFourCC('B', 'C', '5', 'U'))
+			fourCC = MakeFourCC('A', 'T', 'I', '2');
+
+		for (const FormatInfo& info : s_Formats)
+			if (info.FourCC && fourCC == info.FourCC)
+				image.Format = info.Format;
+		image.Srgb = false;
+	}
+
+	if (image.Format == CompressedFormat::Unknown || image.Width <= 0 || image.Height <= 0)
+		return false;
+
+	levelCount = std::min(std::max(1u, levelCount), GetFullChainLevelCount(image.Width, image.Height));
+	if (!SetupLevels(image, levelCount, dataOffset, size))
+		return false;
+
+	// DDS stores the levels back to back from largest to smallest, just like we want them
+	unsigned int dataSize = image.Levels.back().Offset + image.Levels.back().Size;
+	image.Data.assign(file + dataOffset, file + dataOffset + dataSize);
+	return true;
+}
+
+bool LoadKTX2(const unsigned char* file, size_t size, CompressedImage& image)
+{
+	if (size < KTX2HeaderSize || memcmp(file, KTX2Identifier, sizeof(KTX2Identifier)) != 0)
+		return false;
+
+	uint32_t vkFormat = Read32(file, 12);
+	image.Width = (int)Read32(file, 20);
+	image.Height = (int)Read32(file, 24);
+	uint32_t depth = Read32(file, 28);
+	uint32_t layerCount = Read32(file, 32);
+	uint32_t faceCount = Read32(file, 36);
+	unsigned int levelCount = Read32(file, 40);
+	uint32_t supercompression = Read32(file, 44);
+
+	// Basis/zstd supercompressed files would need transcoding first
+	if (depth > 0 || layerCount > 1 || faceCount != 1 || supercompression != 0)
+		return false;
+
+	image.Format = CompressedFormat::Unknown;
+	for (const FormatInfo& info : s_Formats)
+	{
+		if (info.VkLinear && vkFormat == info.VkLinear)
+			image.Format = info.Format, image.Srgb = false;
+		else if (info.VkSrgb && vkFormat == info.VkSrgb)
+			image.Format = info.Format, image.Srgb = true;
+	}
+	// BC1 without alpha (131/132) decodes the same way
+	if (vkFormat == 131 || vkFormat == 132)
+		image.Format = CompressedFormat::BC1, image.Srgb = vkFormat == 132;
+
+	if (image.Format == CompressedFormat::Unknown || image.Width <= 0 || image.Height <= 0)
+		return false;
+
+	levelCount = std::min(std::max(1u, levelCount), GetFullChainLevelCount(image.Width, image.Height));
+	if (size < KTX2HeaderSize + (uint64_t)levelCount * KTX2LevelIndexSize)
+		return false;
+
+	if (!SetupLevels(image, levelCount, 0, size))
+		return false;
+
+	// Unlike DDS the levels can be anywhere in the file (usually smallest first),
+	// so gather them into one tightly packed block
+	image.Data.resize(image.Levels.back().Offset + image.Levels.back().Size);
+	for (size_t i = 0; i < image.Levels.size(); i++)
+	{
+		const CompressedLevel& level = image.Levels[i];
+		uint64_t byteOffset = Read64(file, KTX2HeaderSize + i * KTX2LevelIndexSize);
+		uint64_t byteLength = Read64(file, KTX2HeaderSize + i * KTX2LevelIndexSize + 8);
+
+		if (byteLength != level.Size || byteOffset > size || byteLength > size - byteOffset)
+			return false;
+
+		memcpy(image.Data.data() + level.Offset, file + byteOffset, level.Size);
+	}
+	return true;
+}
+
+namespace {
+	bool WriteDDS(std::vector<unsigned char>& out, const CompressedImage& image, const FormatInfo& info)
+	{
+		// The legacy FourCC header is the most widely readable, only use DX10 when we must
+		bool dx10 = info.FourCC == 0 || image.Srgb;
+		uint32_t dxgiFormat = image.Srgb ? info.DxgiSrgb : info.DxgiLinear;
+		if (dx10 && dxgiFormat == 0)
+			return false;
+
+		unsigned int levelCount = (unsigned int)image.Levels.size();
+
+		Write32(out, DDSMagic);
+		Write32(out, 124);
+		Write32(out, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000); // caps, height, width, pixel format, mip count, linear size
+		Write32(out, image.Height);
+		Write32(out, image.Width);
+		Write32(out, image.Levels[0].Size);
+		Write32(out, 0);
+		Write32(out, levelCount);
+		for (int i = 0; i < 11; i++)
+			Write32(out, 0);
+
+		// Pixel format
+		Write32(out, 32);
+		Write32(out, 0x4); // FourCC
+		Write32(out, dx10 ? MakeFourCC('D', 'X', '1', '0') : info.FourCC);
+		for (int i = 0; i < 5; i++)
+			Write32(out, 0);
+
+		Write32(out, 0x1000 | (levelCount > 1 ? 0x8 | 0x400000 : 0)); // texture, complex + mipmap
+		for (int i = 0; i < 4; i++)
+			Write32(out, 0);
+
+		if (dx10)
+		{
+			Write32(out, dxgiFormat);
+			Write32(out, 3); // 2D texture
+			Write32(out, 0);
+			Write32(out, 1);
+			Write32(out, 0);
+		}
+
+		out.insert(out.end(), image.Data.begin(), image.Data.end());
+		return true;
+	}
+
+	struct DfdSample
+	{
+		uint8_t Channel;
+		bool Linear; // alpha stays linear in an sRGB texture
+	};
+
+	bool WriteKTX2(std::vector<unsigned char>& out, const CompressedImage& image, const FormatInfo& info)
+	{
+		uint32_t vkFormat = image.Srgb ? info.VkSrgb : info.VkLinear;
+		if (vkFormat == 0)
+			return false;
+
+		unsigned int blockSize = CompressedImage::GetBlockSize(image.Format);
+
+		// The data format descriptor only spells out which channels the blocks hold,
+		// one 64 bit sample per half block
+		std::vector<DfdSample> samples;
+		switch (image.Format)
+		{
+		case CompressedFormat::BC1:       samples = { { 1, false } }; break;
+		case CompressedFormat::BC2:
+		case CompressedFormat::BC3:       samples = { { 15, true }, { 0, false } }; break;
+		case CompressedFormat::BC4:       samples = { { 0, false } }; break;
+		case CompressedFormat::BC5:       samples = { { 0, false }, { 1, false } }; break;
+		case CompressedFormat::BC7:       samples = { { 0, false } }; break;
+		case CompressedFormat::ETC2_RGB:  samples = { { 2, false } }; break;
+		case CompressedFormat::ETC2_RGBA: samples = { { 15, true }, { 2, false } }; break;
+		default: return false;
+		}
+
+		std::vector<unsigned char> dfd;
+		unsigned int blockBytes = 24 + 16 * (unsigned int)samples.size();
+		Write32(dfd, 4 + blockBytes);
+		Write32(dfd, 0);                  // Khronos vendor, basic descriptor
+		Write16(dfd, 2);                  // version
+		Write16(dfd, (uint16_t)blockBytes);
+		Write8(dfd, info.DfdModel);
+		Write8(dfd, 1);                   // BT.709 primaries
+		Write8(dfd, image.Srgb ? 2 : 1);  // sRGB or linear transfer
+		Write8(dfd, 0);                   // straight alpha
+		Write32(dfd, 3 | (3 << 8));       // 4x4x1x1 texel blocks, stored minus one
+		Write32(dfd, blockSize);          // bytes in plane 0
+		Write32(dfd, 0);
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			uint8_t bits = (uint8_t)(blockSize * 8 / samples.size());
+			Write16(dfd, (uint16_t)(i * bits));
+			Write8(dfd, bits - 1);
+			Write8(dfd, samples[i].Channel | (image.Srgb && samples[i].Linear ? 0x80 : 0));
+			Write32(dfd, 0);              // sample position
+			Write32(dfd, 0);              // lower
+			Write32(dfd, 0xFFFFFFFF);     // upper
+		}
+
+		unsigned int levelCount = (unsigned int)image.Levels.size();
+		unsigned int dfdOffset = KTX2HeaderSize + levelCount * KTX2LevelIndexSize;
+
+		// Levels go in smallest first so a streamer can show something early,
+		// each aligned to a whole block
+		std::vector<uint64_t> levelOffsets(levelCount);
+		uint64_t offset = dfdOffset + dfd.size();
+		for (int i = (int)levelCount - 1; i >= 0; i--)
+		{
+			offset = (offset + blockSize - 1) / blockSize * blockSize;
+			levelOffsets[i] = offset;
+			offset += image.Levels[i].Size;
+		}
+
+		out.insert(out.end(), KTX2Identifier, KTX2Identifier + sizeof(KTX2Identifier));
+		Write32(out, vkFormat);
+		Write32(out, 1);                  // type size for block compressed formats
+		Write32(out, image.Width);
+		Write32(out, image.Height);
+		Write32(out, 0);                  // depth
+		Write32(out, 0);                  // layers
+		Write32(out, 1);                  // faces
+		Write32(out, levelCount);
+		Write32(out, 0);                  // no supercompression
+
+		Write32(out, dfdOffset);
+		Write32(out, (uint32_t)dfd.size());
+		Write32(out, 0);                  // no key/value data
+		Write32(out, 0);
+		Write64(out, 0);                  // no supercompression global data
+		Write64(out, 0);
+
+		for (unsigned int i = 0; i < levelCount; i++)
+		{
+			Write64(out, levelOffsets[i]);
+			Write64(out, image.Levels[i].Size);
+			Write64(out, image.Levels[i].Size);
+		}
+
+		out.insert(out.end(), dfd.begin(), dfd.end());
+
+		for (int i = (int)levelCount - 1; i >= 0; i--)
+		{
+			out.resize((size_t)levelOffsets[i], 0);
+			const unsigned char* level = image.Data.data() + image.Levels[i].Offset;
+			out.insert(out.end(), level, level + image.Levels[i].Size);
+		}
+		return true;
+	}
+}
+
+bool WriteCompressedImage(const std::string& path, const CompressedImage& image)
+{
+	const FormatInfo* info = FindFormat(image.Format);
+	if (!info || image.Levels.empty())
+		return false;
+
+	std::vector<unsigned char> out;
+	bool dds = GetExtension(path) == "dds";
+	if (!(dds ? WriteDDS(out, image, *info) : WriteKTX2(out, image, *info)))
+	{
+		std::cout << "Warning: '" << path << "' can't hold this texture format" << std::endl;
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	file.write((const char*)out.data(), out.size());
+	return file.good();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+// Block compressed formats we know how to read from (and write to) a container
+enum class CompressedFormat
+{
+	BC1, BC2, BC3, BC4, BC5, BC7,
+	ETC2_RGB, ETC2_RGBA,
+	Unknown
+};
+
+struct CompressedLevel
+{
+	int Width, Height;
+	unsigned int Offset; // into CompressedImage::Data
+	unsigned int Size;
+};
+
+/**
+ * A pre-compressed image with its whole mip chain, as stored in a DDS or KTX2 file.
+ * Levels go from largest to smallest and are ready for glCompressedTexImage2D.
+ */
+struct CompressedImage
+{
+	CompressedFormat Format = CompressedFormat::Unknown;
+	bool Srgb = false;
+	int Width = 0, Height = 0;
+	std::vector<CompressedLevel> Levels;
+	std::vector<unsigned char> Data;
+
+	GLenum GetInternalFormat() const;
+	// True if the current context can sample this format
+	bool IsSupported() const;
+
+	// Bytes per 4x4 block: 8 for BC1/BC4/ETC2 RGB, 16 for the rest
+	static unsigned int GetBlockSize(CompressedFormat format);
+	static uint64_t GetLevelSize(CompressedFormat format, int width, int height);
+};
+
+// Picks the loader by extension (.dds or .ktx2), prints a warning and returns false on failure
+bool IsCompressedImagePath(const std::string& path);
+bool LoadCompressedImage(const std::string& path, CompressedImage& image);
+bool LoadDDS(const unsigned char* file, size_t size, CompressedImage& image);
+bool LoadKTX2(const unsigned char* file, size_t size, CompressedImage& image);
+
+// DDS can't hold ETC2, KTX2 holds everything
+bool WriteCompressedImage(const std::string& path, const CompressedImage& image);
@@ -0,0 +1,270 @@
+#include "TextureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "stb_image/stb_image.h"
+
+#include "GLState.h"
+#include "AssetArchive.h"
+#include "CpuProfiler.h"
+#include "RenderStats.h"
+
+// Shown until the real image is resident
+static const unsigned int s_Placeholder = 0xff808080;
+
+TextureLoader::TextureLoader(unsigned int workerCount /*= 0*/, unsigned int bytesPerFrame /*= 4MB*/,
+	unsigned int pixelBufferCount /*= 4*/, unsigned int pixelBufferSize /*= 1MB*/)
+	: m_BytesPerFrame(bytesPerFrame),
+	  m_PixelBufferSize(pixelBufferSize),
+	  m_Shutdown(false),
+	  m_Pending(0),
+	  m_PixelBuffers(pixelBufferCount),
+	  m_NextPixelBuffer(0),
+	  m_Stats{ 0, 0, 0, 0 }
+{
+	glGenBuffers(pixelBufferCount, m_PixelBuffers.data());
+	for (unsigned int pbo : m_PixelBuffers)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, pixelBufferSize, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// The flip flag is global in stb_image, set it before any worker reads it.
+	// Same as Texture, all our images are loaded bottom row first
+	stbi_set_flip_vertically_on_load(1);
+
+	if (workerCount == 0)
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	for (unsigned int i = 0; i < workerCount; i++)
+		m_Workers.emplace_back(&TextureLoader::WorkerMain, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Shutdown = true;
+	}
+	m_WorkAvailable.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+
+	for (Request& request : m_Uploads)
+		glDeleteTextures(1, &request.RendererID);
+
+	glDeleteBuffers((int)m_PixelBuffers.size(), m_PixelBuffers.data());
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string& path, Mipmaps mipmaps /*= Mipmaps::Cpu*/)
+{
+	std::shared_ptr<Texture> texture = std::make_shared<Texture>(1, 1, &s_Placeholder);
+	texture->m_FilePath = path;
+	texture->m_Resident = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_DecodeQueue.push_back({ texture, path, mipmaps, MipChain(), 0, 0, 0 });
+		m_Pending++;
+	}
+	m_WorkAvailable.notify_one();
+
+	return texture;
+}
+
+void TextureLoader::WorkerMain()
+{
+	CpuProfiler::SetThreadName("Texture Loader");
+
+	while (true)
+	{
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this] { return m_Shutdown || !m_DecodeQueue.empty(); });
+			if (m_Shutdown)
+				return;
+
+			request = std::move(m_DecodeQueue.front());
+			m_DecodeQueue.pop_front();
+		}
+
+		Decode(request);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Decoded.push_back(std::move(request));
+	}
+}
+
+void TextureLoader::Decode(Request& request)
+{
+	PROFILE_FUNCTION();
+	AssetView file = AssetArchive::Read(request.Path);
+
+	int width, height, bpp;
+	unsigned char* pixels = nullptr;
+	if (file.IsValid())
+		pixels = stbi_load_from_memory(file.GetData(), (int)file.GetSize(), &width, &height, &bpp, 4);
+
+	if (!pixels)
+	{
+		std::cout << "Warning: failed to load texture '" << request.Path << "'" << std::endl;
+		return;
+	}
+
+	// Filtering the chain here keeps it off the render thread
+	if (request.Mode == Mipmaps::Cpu || request.Mode == Mipmaps::CpuLinear)
+	{
+		request.Image = GenerateMipChain(pixels, width, height, request.Mode == Mipmaps::Cpu);
+	}
+	else
+	{
+		request.Image.Data.assign(pixels, pixels + width * height * 4);
+		request.Image.Levels.push_back({ width, height, 0 });
+	}
+	stbi_image_free(pixels);
+}
+
+void TextureLoader::Update()
+{
+	PROFILE_FUNCTION();
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		while (!m_Decoded.empty())
+		{
+			m_Uploads.push_back(std::move(m_Decoded.front()));
+			m_Decoded.pop_front();
+			m_Pending--;
+		}
+		m_Stats.Pending = m_Pending;
+	}
+
+	unsigned int budget = m_BytesPerFrame;
+	m_Stats.BytesUploadedLastFrame = 0;
+
+	while (!m_Uploads.empty())
+	{
+		Request& request = m_Uploads.front();
+
+		// Nobody is holding on to the texture anymore, or it failed to decode
+		if (request.Target.use_count() == 1 || request.Image.Levels.empty())
+		{
+			if (request.RendererID)
+				glDeleteTextures(1, &request.RendererID);
+			m_Uploads.pop_front();
+			continue;
+		}
+
+		if (budget == 0)
+			break;
+
+		unsigned int uploaded = UploadRows(request, budget);
+		budget -= std::min(budget, uploaded);
+		m_Stats.BytesUploadedLastFrame += uploaded;
+
+		if (request.Level < request.Image.Levels.size())
+			break;
+
+		Finish(request);
+		m_Uploads.pop_front();
+		m_Stats.Completed++;
+	}
+
+	m_Stats.Uploading = (unsigned int)m_Uploads.size();
+}
+
+unsigned int TextureLoader::UploadRows(Request& request, unsigned int budget)
+{
+	GLState& state = GLState::Current();
+
+	if (!request.RendererID)
+	{
+		glGenTextures(1, &request.RendererID);
+		state.BindTexture(0, GL_TEXTURE_2D, request.RendererID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, request.Mode == Mipmaps::None ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// A GPU filtered chain only has level 0 to upload but needs room for the rest
+		const MipLevel& top = request.Image.Levels[0];
+		int levels = request.Mode == Mipmaps::Gpu ? GetMipLevelCount(top.Width, top.Height) : (int)request.Image.Levels.size();
+		Texture::AllocateStorage(levels, top.Width, top.Height);
+	}
+	else
+	{
+		state.BindTexture(0, GL_TEXTURE_2D, request.RendererID);
+	}
+
+	unsigned int uploaded = 0;
+
+	while (request.Level < request.Image.Levels.size())
+	{
+		const MipLevel& level = request.Image.Levels[request.Level];
+		unsigned int rowSize = level.Width * 4;
+
+		// Always make some progress, even if a single row is over budget
+		if (uploaded > 0 && uploaded + rowSize > budget)
+			break;
+
+		unsigned int rows = std::max(1u, std::min(budget - std::min(budget, uploaded), m_PixelBufferSize) / rowSize);
+		rows = std::min(rows, (unsigned int)(level.Height - request.RowsUploaded));
+		unsigned int size = rows * rowSize;
+
+		// Invalidating the buffer lets the driver hand us fresh memory instead of
+		// waiting for the previous upload from this PBO to finish
+		unsigned int pbo = m_PixelBuffers[m_NextPixelBuffer];
+		m_NextPixelBuffer = (m_NextPixelBuffer + 1) % m_PixelBuffers.size();
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+		if (size > m_PixelBufferSize)
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		// The request keeps its place, so the next Update() retries from this row
+		if (!dst)
+			break;
+		memcpy(dst, request.Image.GetLevelData(request.Level) + request.RowsUploaded * rowSize, size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+		glTexSubImage2D(GL_TEXTURE_2D, (int)request.Level, 0, request.RowsUploaded, level.Width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		request.RowsUploaded += rows;
+		uploaded += size;
+		RenderStats::Get().Add(RenderStats::TextureBytes, size);
+
+		if (request.RowsUploaded == level.Height)
+		{
+			request.Level++;
+			request.RowsUploaded = 0;
+		}
+	}
+
+	// Client memory uploads elsewhere would read from the PBO otherwise
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	return uploaded;
+}
+
+void TextureLoader::Finish(Request& request)
+{
+	if (request.Mode == Mipmaps::Gpu)
+	{
+		GLState::Current().BindTexture(0, GL_TEXTURE_2D, request.RendererID);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	Texture& texture = *request.Target;
+	GLState::Current().OnDeleteTexture(texture.m_RendererID);
+	glDeleteTextures(1, &texture.m_RendererID);
+
+	texture.m_RendererID = request.RendererID;
+	texture.m_Width = request.Image.Levels[0].Width;
+	texture.m_Height = request.Image.Levels[0].Height;
+	texture.m_BPP = 4;
+	texture.m_Levels = request.Mode == Mipmaps::Gpu ? GetMipLevelCount(texture.m_Width, texture.m_Height) : (int)request.Image.Levels.size();
+	texture.m_Resident = true;
+	request.RendererID = 0;
+	request.Image = MipChain();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Texture.h"
+#include "MipGenerator.h"
+
+/**
+ * Loads textures without stalling the render thread.
+ *
+ * Load() returns right away with a placeholder texture. Worker threads read and decode
+ * the file (stbi_load_from_memory) and, for Mipmaps::Cpu, filter the mip chain. Then
+ * Update(), called once per frame on the GL thread, streams the levels in through a
+ * small pool of pixel buffer objects, a few rows at a time, never uploading more than
+ * the per-frame byte budget. Once the last row is in, the texture swaps its
+ * placeholder for the real thing.
+ */
+class TextureLoader
+{
+public:
+	struct Stats
+	{
+		unsigned int Pending;  // waiting for or being decoded
+		unsigned int Uploading;
+		unsigned int Completed;
+		unsigned int BytesUploadedLastFrame;
+	};
+private:
+	struct Request
+	{
+		std::shared_ptr<Texture> Target;
+		std::string Path;
+		Mipmaps Mode;
+		MipChain Image;        // empty if decoding failed
+		size_t Level;          // being uploaded
+		int RowsUploaded;      // of that level
+		unsigned int RendererID; // the real texture while it is being filled
+	};
+
+	unsigned int m_BytesPerFrame;
+	unsigned int m_PixelBufferSize;
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	std::deque<Request> m_DecodeQueue;
+	std::deque<Request> m_Decoded;
+	bool m_Shutdown;
+	unsigned int m_Pending;
+
+	// GL thread only
+	std::deque<Request> m_Uploads;
+	std::vector<unsigned int> m_PixelBuffers;
+	unsigned int m_NextPixelBuffer;
+	Stats m_Stats;
+public:
+	// workerCount 0 = one less than the hardware threads (at least one)
+	TextureLoader(unsigned int workerCount = 0, unsigned int bytesPerFrame = 4 * 1024 * 1024,
+		unsigned int pixelBufferCount = 4, unsigned int pixelBufferSize = 1024 * 1024);
+	~TextureLoader();
+
+	std::shared_ptr<Texture> Load(const std::string& path, Mipmaps mipmaps = Mipmaps::Cpu);
+
+	// Call once per frame on the GL thread
+	void Update();
+
+	inline const Stats& GetStats() const { return m_Stats; }
+private:
+	void WorkerMain();
+	void Decode(Request& request);
+	// Returns the number of bytes uploaded
+	unsigned int UploadRows(Request& request, unsigned int budget);
+	void Finish(Request& request);
+};
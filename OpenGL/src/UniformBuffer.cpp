@@ -0,0 +1,82 @@
+#include "UniformBuffer.h"
+
+#include <cstring>
+
+#include "Debug.h"
+#include "RenderStats.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int usage /*= GL_DYNAMIC_DRAW*/)
+	: m_Size(size)
+{
+	glGenBuffers(1, &m_RendererID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, usage);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	glDeleteBuffers(1, &m_RendererID);
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset /*= 0*/)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
+	RenderStats::Get().Add(RenderStats::BufferBytes, size);
+}
+
+void UniformBuffer::BindBase(unsigned int binding) const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+}
+
+void UniformBuffer::BindRange(unsigned int binding, unsigned int offset, unsigned int size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_RendererID, offset, size);
+}
+
+unsigned int UniformBuffer::GetOffsetAlignment()
+{
+	static int alignment = 0;
+	if (!alignment)
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return (unsigned int)alignment;
+}
+
+DynamicUniformBuffer::DynamicUniformBuffer(unsigned int size)
+	: UniformBuffer(size, GL_STREAM_DRAW),
+	  m_Staging(size),
+	  m_Head(0)
+{
+}
+
+unsigned int DynamicUniformBuffer::Allocate(const void* data, unsigned int size)
+{
+	unsigned int alignment = GetOffsetAlignment();
+	unsigned int offset = (m_Head + alignment - 1) / alignment * alignment;
+	ASSERT(offset + size <= m_Size);
+
+	memcpy(m_Staging.data() + offset, data, size);
+	m_Head = offset + size;
+	return offset;
+}
+
+void DynamicUniformBuffer::Upload()
+{
+	if (m_Head == 0)
+		return;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+	glBufferData(GL_UNIFORM_BUFFER, m_Size, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, m_Head, m_Staging.data());
+
+	RenderStats::Get().Add(RenderStats::UniformUpdates);
+	RenderStats::Get().Add(RenderStats::BufferBytes, m_Head);
+}
+
+void DynamicUniformBuffer::Reset()
+{
+	m_Head = 0;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "glm/glm.hpp"
+
+class UniformBuffer
+{
+protected:
+	unsigned int m_RendererID;
+	unsigned int m_Size;
+public:
+	UniformBuffer(unsigned int size, unsigned int usage = GL_DYNAMIC_DRAW);
+	virtual ~UniformBuffer();
+
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+	// Binds the whole buffer to a binding point shared by every program
+	void BindBase(unsigned int binding) const;
+	// Binds [offset, offset + size) only, offset must be a multiple of GetOffsetAlignment()
+	void BindRange(unsigned int binding, unsigned int offset, unsigned int size) const;
+
+	inline unsigned int GetSize() const { return m_Size; }
+
+	// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	static unsigned int GetOffsetAlignment();
+};
+
+/**
+ * A uniform buffer sub-allocated linearly every frame, for data that changes per draw.
+ *
+ * Blocks are staged on the CPU with Allocate, uploaded all at once with Upload and then
+ * selected per draw with BindRange(binding, offset, blockSize).
+ */
+class DynamicUniformBuffer : public UniformBuffer
+{
+private:
+	std::vector<unsigned char> m_Staging;
+	unsigned int m_Head;
+public:
+	DynamicUniformBuffer(unsigned int size);
+
+	// Copies `size` bytes into the staging area, returns the offset to pass to BindRange
+	unsigned int Allocate(const void* data, unsigned int size);
+	// Orphans the old storage and uploads everything allocated since Reset
+	void Upload();
+	void Reset();
+};
+
+/**
+ * Computes std140 offsets, mirroring the order members are declared in the GLSL block.
+ *
+ *   UniformBufferLayout layout;
+ *   unsigned int projOffset = layout.Push<glm::mat4>();
+ *   unsigned int timeOffset = layout.Push<float>();
+ *   UniformBuffer ubo(layout.GetSize());
+ */
+class UniformBufferLayout
+{
+private:
+	unsigned int m_Size;
+public:
+	UniformBufferLayout()
+		: m_Size(0) { };
+
+	// Returns the offset of the pushed member. Arrays (count > 1) get a 16 byte element stride
+	template<typename T>
+	unsigned int Push(unsigned int count = 1)
+	{
+		static_assert(sizeof(T) == 0, "UniformBufferLayout::Push: unsupported type");
+		return 0;
+	}
+
+	// The size of a block is rounded up to the alignment of a vec4
+	inline unsigned int GetSize() const { return (m_Size + 15) & ~15u; }
+private:
+	unsigned int Add(unsigned int size, unsigned int alignment, unsigned int count)
+	{
+		if (count > 1)
+		{
+			alignment = 16;
+			size = (size + 15) & ~15u;
+		}
+
+		unsigned int offset = (m_Size + alignment - 1) & ~(alignment - 1);
+		m_Size = offset + size * count;
+		return offset;
+	}
+};
+
+template<>
+inline unsigned int UniformBufferLayout::Push<float>(unsigned int count)
+{
+	return Add(4, 4, count);
+}
+
+template<>
+inline unsigned int UniformBufferLayout::Push<int>(unsigned int count)
+{
+	return Add(4, 4, count);
+}
+
+template<>
+inline unsigned int UniformBufferLayout::Push<glm::vec2>(unsigned int count)
+{
+	return Add(8, 8, count);
+}
+
+template<>
+inline unsigned int UniformBufferLayout::Push<glm::vec3>(unsigned int count)
+{
+	return Add(12, 16, count);
+}
+
+template<>
+inline unsigned int UniformBufferLayout::Push<glm::vec4>(unsigned int count)
+{
+	return Add(16, 16, count);
+}
+
+// Column major, four vec4 columns
+template<>
+inline unsigned int UniformBufferLayout::Push<glm::mat4>(unsigned int count)
+{
+	return Add(64, 16, count);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * A uniform name reduced to its 32-bit FNV-1a hash. Declared constexpr the hash is
+ * computed by the compiler, so setting a uniform doesn't touch the name at all:
+ *
+ *   static constexpr UniformId u_MVP("u_MVP");
+ *   shader.SetUniformMatrix4f(u_MVP, mvp);
+ *
+ * Plain string literals convert implicitly but are hashed at runtime on every call, fine
+ * for one-off setup, hot paths should use a constexpr handle like above. Name must
+ * outlive the UniformId, which is why there is no std::string overload.
+ */
+struct UniformId
+{
+	uint32_t Hash;
+	const char* Name; // for diagnostics only, not owned
+
+	constexpr UniformId(const char* name)
+		: Hash(HashName(name)), Name(name) { }
+
+	static constexpr uint32_t HashName(const char* str, uint32_t hash = 2166136261u)
+	{
+		return *str ? HashName(str + 1, (hash ^ (uint8_t)*str) * 16777619u) : hash;
+	}
+};
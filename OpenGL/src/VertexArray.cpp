@@ -1,8 +1,10 @@
 #include "VertexArray.h"
 
 #include "Renderer.h"
+#include "GLState.h"
 
 VertexArray::VertexArray()
+	: m_AttribIndex(0)
 {
 	glGenVertexArrays(1, &m_RendererID);
 }
@@ -10,6 +12,7 @@ VertexArray::VertexArray()
 
 VertexArray::~VertexArray()
 {
+	GLState::Current().OnDeleteVertexArray(m_RendererID);
 	glDeleteVertexArrays(1, &m_RendererID);
 }
 
@@ -23,25 +26,29 @@ void VertexArray::AddBuffer(const VertexBuffer & vb, const VertexBufferLayout &
 	for (unsigned int i = 0; i < elements.size(); i++)
 	{
 		const auto& element = elements[i];
-		glEnableVertexAttribArray(i);
+		unsigned int location = m_AttribIndex + i;
+		glEnableVertexAttribArray(location);
 		glVertexAttribPointer(
-			i,
+			location,
 			element.count,
 			element.type,
 			element.normalized,
 			layout.GetStride(),
-			(const void*)offset // TODO: what?
+			(const void*)(size_t)offset // a byte offset into the bound buffer, passed as a pointer for historical reasons
 		);
+		if (element.divisor)
+			glVertexAttribDivisor(location, element.divisor);
 		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
 	}
+	m_AttribIndex += (unsigned int)elements.size();
 }
 
 void VertexArray::Bind() const
 {
-	glBindVertexArray(m_RendererID);
+	GLState::Current().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-	glBindVertexArray(0);
+	GLState::Current().BindVertexArray(0);
 }
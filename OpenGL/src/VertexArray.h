@@ -1,12 +1,13 @@
 #pragma once
 
-#include "Vertexbuffer.h"
+#include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 
 class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_AttribIndex; // next free attribute location, so multiple buffers can be added
 public:
 	VertexArray();
 	~VertexArray();
@@ -15,5 +16,7 @@ public:
 
 	void Bind() const;
 	void Unbind() const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 };
 
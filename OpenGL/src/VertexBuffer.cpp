@@ -1,22 +1,48 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
+#include "GLState.h"
+#include "RenderStats.h"
 
 VertexBuffer::VertexBuffer(const void * data, unsigned int size)
 {
 	glGenBuffers(1, &m_RendererID);
-	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	GLState::Current().BindArrayBuffer(m_RendererID);
 	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+	RenderStats::Get().Add(RenderStats::BufferBytes, size);
+}
+
+VertexBuffer::VertexBuffer(unsigned int size)
+{
+	glGenBuffers(1, &m_RendererID);
+	GLState::Current().BindArrayBuffer(m_RendererID);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
+VertexBuffer::VertexBuffer()
+{
+	glGenBuffers(1, &m_RendererID);
 }
 
 VertexBuffer::~VertexBuffer()
 {
+	GLState::Current().OnDeleteBuffer(m_RendererID);
+	glDeleteBuffers(1, &m_RendererID);
+}
+
+void VertexBuffer::SetData(const void * data, unsigned int size, unsigned int offset /*= 0*/)
+{
+	GLState::Current().BindArrayBuffer(m_RendererID);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	RenderStats::Get().Add(RenderStats::BufferBytes, size);
 }
 
 void VertexBuffer::Bind() const
 {
+	GLState::Current().BindArrayBuffer(m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
+	GLState::Current().BindArrayBuffer(0);
 }
 
@@ -2,12 +2,19 @@
 
 class VertexBuffer
 {
-private:
+protected:
 	unsigned int m_RendererID;
 public:
 	VertexBuffer(const void* data, unsigned int size);
-	~VertexBuffer();
+	// Allocates `size` bytes of GL_DYNAMIC_DRAW storage to be filled later via SetData
+	VertexBuffer(unsigned int size);
+	virtual ~VertexBuffer();
+
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
 
 	void Bind() const;
 	void Unbind() const;
-};
\ No newline at end of file
+protected:
+	// Generates the buffer name only, storage is up to the derived class
+	VertexBuffer();
+};
@@ -4,11 +4,14 @@
 #include <vector>
 #include <GL/glew.h>
 
+#include "glm/glm.hpp"
+
 struct VertexBufferElement
 {
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	unsigned int divisor; // 0 = per vertex, N = advance once every N instances
 
 	static unsigned int GetSizeOfType(unsigned int type)
 	{
@@ -35,30 +38,10 @@ public:
 
 	// TODO: I guess I need to learn c++ templates
 	template<typename T>
-	void Push(unsigned int count)	
-	{
-		static_assert(false); // TODO: what does this do?
-	}
-
-	template<>
-	void Push<float>(unsigned int count)
-	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
-	}
-
-	template<>
-	void Push<unsigned int>(unsigned int count)
-	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-	}
-
-	template<>
-	void Push<unsigned char>(unsigned int count)
+	void Push(unsigned int count, unsigned int divisor = 0)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		// Only the specializations below exist, any other T fails to compile here
+		static_assert(sizeof(T) == 0, "VertexBufferLayout::Push: unsupported type");
 	}
 
 	// TODO: what is inline and why would you do it here rather than in the .cpp?
@@ -69,3 +52,32 @@ public:
 	inline unsigned int GetStride() const { return m_Stride;  }
 };
 
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count, unsigned int divisor)
+{
+	m_Elements.push_back({ GL_FLOAT, count, GL_FALSE, divisor });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count, unsigned int divisor)
+{
+	m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE, divisor });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count, unsigned int divisor)
+{
+	m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE, divisor });
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+// A mat4 attribute takes up four consecutive locations, one vec4 column each
+template<>
+inline void VertexBufferLayout::Push<glm::mat4>(unsigned int count, unsigned int divisor)
+{
+	for (unsigned int i = 0; i < count * 4; i++)
+		Push<float>(4, divisor);
+}
+
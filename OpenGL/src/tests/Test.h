@@ -2,6 +2,8 @@
 
 #include "Renderer.h"
 
+struct FramePacket;
+
 namespace test {
 	class Test
 	{
@@ -13,5 +15,13 @@ namespace test {
 		// TODO: move windowX and windowY to constructor
 		virtual void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) {}
 		virtual void OnImGuiRender(unsigned int windowX, unsigned int windowY) {}
+
+		// Optional split of OnRender so the simulation can run on its own thread (see
+		// SimulationThread). OnBuildFrame must not call GL, it describes the frame in the
+		// packet, whose window size, time and interpolation are already filled in.
+		// OnRenderFrame then draws the packet on the GL thread.
+		virtual bool HasFramePackets() const { return false; }
+		virtual void OnBuildFrame(FramePacket& packet) {}
+		virtual void OnRenderFrame(Renderer &renderer, const FramePacket& packet) {}
 	};
 }
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TestAsyncShaders.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+static constexpr UniformId u_Texture("u_Texture");
+static constexpr UniformId u_MVP("u_MVP");
+static constexpr UniformId u_Color("u_Color");
+
+static const float s_Positions[] = {
+	-0.5f, -0.5f, 0.0f, 0.0f, // 0 -- bottom left
+	 0.5f, -0.5f, 1.0f, 0.0f, // 1 -- bottom right
+	 0.5f,  0.5f, 1.0f, 1.0f, // 2 -- top right
+	-0.5f,  0.5f, 0.0f, 1.0f  // 3 -- top left
+};
+
+static const unsigned int s_Indices[] = {
+	0, 1, 2,
+	2, 3, 0
+};
+
+namespace test {
+	TestAsyncShaders::TestAsyncShaders()
+		: m_PermutationCount(64),
+		m_Generation(0),
+		m_ReadyCount(0),
+		m_VertexBuffer(s_Positions, sizeof(s_Positions)),
+		m_IndexBuffer(s_Indices, 6),
+		m_FallbackShader("Basic"),
+		m_Texture("res/textures/dice.png")
+	{
+		m_Layout.Push<float>(2); // vertex coordinates
+		m_Layout.Push<float>(2); // texture coordinates
+		m_VertexArray.AddBuffer(m_VertexBuffer, m_Layout);
+
+		m_VertexArray.Unbind();
+	}
+
+
+	TestAsyncShaders::~TestAsyncShaders()
+	{
+	}
+
+	void TestAsyncShaders::CompilePermutations()
+	{
+		// The generation define makes every batch unique, so they can't come from the binary cache
+		m_Generation++;
+		m_Permutations.clear();
+		for (int i = 0; i < m_PermutationCount; i++)
+		{
+			std::vector<std::string> defines = {
+				"PERMUTATION " + std::to_string(i),
+				"GENERATION " + std::to_string(m_Generation)
+			};
+			m_Permutations.emplace_back(new Shader("Basic", defines, ShaderCompileMode::Async));
+		}
+	}
+
+	void TestAsyncShaders::OnUpdate(float deltaTime)
+	{
+		m_ReadyCount = 0;
+		for (auto& shader : m_Permutations)
+		{
+			if (shader->IsReady())
+				m_ReadyCount++;
+		}
+	}
+
+	void TestAsyncShaders::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+
+		int perRow = (int)std::ceil(std::sqrt((float)m_Permutations.size()));
+		float cellX = (float)windowX / std::max(perRow, 1);
+		float cellY = (float)windowY / std::max(perRow, 1);
+
+		m_Texture.Bind(0);
+		for (int i = 0; i < (int)m_Permutations.size(); i++)
+		{
+			Shader& permutation = *m_Permutations[i];
+			bool ready = permutation.IsReady() && permutation.IsValid();
+			Shader& shader = ready ? permutation : m_FallbackShader;
+
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((i % perRow + 0.5f) * cellX, (i / perRow + 0.5f) * cellY, 0.0f));
+			model = glm::scale(model, glm::vec3(cellX * 0.8f, cellY * 0.8f, 1.0f));
+
+			shader.Bind();
+			shader.SetUniform1i(u_Texture, 0);
+			shader.SetUniformMatrix4f(u_MVP, proj * model);
+			// Fallback quads are drawn grey so the swap over is visible
+			if (ready)
+				shader.SetUniform4f(u_Color, 0.2f, 0.8f, 0.3f, 1.0f);
+			else
+				shader.SetUniform4f(u_Color, 0.5f, 0.5f, 0.5f, 1.0f);
+
+			renderer.Draw(m_VertexArray, m_IndexBuffer, shader);
+		}
+	}
+
+	void TestAsyncShaders::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Permutations", &m_PermutationCount, 1, 256);
+		if (ImGui::Button("Compile"))
+			CompilePermutations();
+		ImGui::Text("Ready: %u / %u", m_ReadyCount, (unsigned int)m_Permutations.size());
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+#include "Renderer.h"
+#include "Texture.h"
+
+namespace test {
+	class TestAsyncShaders : public Test
+	{
+	public:
+		TestAsyncShaders();
+		~TestAsyncShaders();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		int m_PermutationCount;
+		unsigned int m_Generation;
+		unsigned int m_ReadyCount;
+
+		VertexArray m_VertexArray;
+		VertexBuffer m_VertexBuffer;
+		VertexBufferLayout m_Layout;
+		IndexBuffer m_IndexBuffer;
+
+		// Drawn with until the permutation it stands in for is ready
+		Shader m_FallbackShader;
+		std::vector<std::unique_ptr<Shader>> m_Permutations;
+		Texture m_Texture;
+
+		void CompilePermutations();
+	};
+}
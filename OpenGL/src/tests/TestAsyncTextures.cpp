@@ -0,0 +1,82 @@
+#include "TestAsyncTextures.h"
+
+#include <cmath>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+namespace test {
+	TestAsyncTextures::TestAsyncTextures()
+		: m_TextureCount(64),
+		m_KilobytesPerFrame(256)
+	{
+	}
+
+
+	TestAsyncTextures::~TestAsyncTextures()
+	{
+	}
+
+	void TestAsyncTextures::LoadTextures()
+	{
+		// Drop the old textures before the loader so it can skip anything still in flight
+		m_Textures.clear();
+		m_Loader.reset(new TextureLoader(0, m_KilobytesPerFrame * 1024));
+
+		for (int i = 0; i < m_TextureCount; i++)
+			m_Textures.push_back(m_Loader->Load(i % 2 ? "res/textures/tenor.png" : "res/textures/dice.png"));
+	}
+
+	void TestAsyncTextures::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestAsyncTextures::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// Loading starts the first time the test is shown, not at startup
+		if (!m_Loader)
+			LoadTextures();
+
+		m_Loader->Update();
+
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+
+		int perRow = (int)ceilf(sqrtf((float)m_Textures.size()));
+		float cellX = (float)windowX / perRow;
+		float cellY = (float)windowY / perRow;
+
+		m_BatchRenderer.BeginBatch(renderer, proj);
+		for (size_t i = 0; i < m_Textures.size(); i++)
+		{
+			int x = (int)i % perRow;
+			int y = (int)i / perRow;
+
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3((x + 0.5f) * cellX, (y + 0.5f) * cellY, 0.0f));
+			transform = glm::scale(transform, glm::vec3(cellX * 0.9f, cellY * 0.9f, 1.0f));
+
+			m_BatchRenderer.SubmitQuad(transform, glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), m_Textures[i].get());
+		}
+		m_BatchRenderer.EndBatch();
+	}
+
+	void TestAsyncTextures::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Textures", &m_TextureCount, 1, 256);
+		ImGui::SliderInt("Upload budget (KB/frame)", &m_KilobytesPerFrame, 16, 8192);
+		if (ImGui::Button("Reload"))
+			LoadTextures();
+
+		if (m_Loader)
+		{
+			const TextureLoader::Stats& stats = m_Loader->GetStats();
+			ImGui::Text("Decoding: %u, uploading: %u, resident: %u", stats.Pending, stats.Uploading, stats.Completed);
+			ImGui::Text("Uploaded this frame: %.1f KB", stats.BytesUploadedLastFrame / 1024.0f);
+		}
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "TextureLoader.h"
+
+namespace test {
+	class TestAsyncTextures : public Test
+	{
+	public:
+		TestAsyncTextures();
+		~TestAsyncTextures();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		void LoadTextures();
+
+		int m_TextureCount;
+		int m_KilobytesPerFrame;
+
+		BatchRenderer m_BatchRenderer;
+		std::unique_ptr<TextureLoader> m_Loader;
+		std::vector<std::shared_ptr<Texture>> m_Textures;
+	};
+}
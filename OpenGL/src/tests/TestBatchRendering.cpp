@@ -0,0 +1,73 @@
+#include "TestBatchRendering.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+namespace test {
+	TestBatchRendering::TestBatchRendering()
+		: m_QuadsPerRow(100),
+		m_Rotation(0.0f),
+		m_PreviousRotation(0.0f),
+		m_DiceTexture("res/textures/dice.png"),
+		m_TenorTexture("res/textures/tenor.png")
+	{
+	}
+
+
+	TestBatchRendering::~TestBatchRendering()
+	{
+	}
+
+	void TestBatchRendering::OnUpdate(float deltaTime)
+	{
+		m_PreviousRotation = m_Rotation;
+		m_Rotation += 0.6f * deltaTime; // radians per second
+	}
+
+	void TestBatchRendering::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+
+		float rotation = glm::mix(m_PreviousRotation, m_Rotation, renderer.GetInterpolation());
+
+		float cellX = (float)windowX / m_QuadsPerRow;
+		float cellY = (float)windowY / m_QuadsPerRow;
+
+		m_BatchRenderer.BeginBatch(renderer, proj);
+		for (int y = 0; y < m_QuadsPerRow; y++)
+		{
+			for (int x = 0; x < m_QuadsPerRow; x++)
+			{
+				glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3((x + 0.5f) * cellX, (y + 0.5f) * cellY, 0.0f));
+				transform = glm::rotate(transform, rotation, glm::vec3(0, 0, 1));
+				transform = glm::scale(transform, glm::vec3(cellX * 0.9f, cellY * 0.9f, 1.0f));
+
+				glm::vec4 color((float)x / m_QuadsPerRow, 0.3f, (float)y / m_QuadsPerRow, 1.0f);
+
+				// Mix untextured and textured quads so several texture slots are in use
+				const Texture* texture = nullptr;
+				if ((x + y) % 3 == 1)
+					texture = &m_DiceTexture;
+				else if ((x + y) % 3 == 2)
+					texture = &m_TenorTexture;
+
+				m_BatchRenderer.SubmitQuad(transform, color, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), texture);
+			}
+		}
+		m_BatchRenderer.EndBatch();
+	}
+
+	void TestBatchRendering::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		const BatchRenderer::Stats& stats = m_BatchRenderer.GetStats();
+
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Quads per row", &m_QuadsPerRow, 1, 300);
+		ImGui::Text("Quads: %u, draw calls: %u", stats.QuadCount, stats.DrawCalls);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
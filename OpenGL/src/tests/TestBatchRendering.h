@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "Texture.h"
+
+namespace test {
+	class TestBatchRendering : public Test
+	{
+	public:
+		TestBatchRendering();
+		~TestBatchRendering();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		int m_QuadsPerRow;
+		float m_Rotation;
+		float m_PreviousRotation;
+
+		BatchRenderer m_BatchRenderer;
+		Texture m_DiceTexture;
+		Texture m_TenorTexture;
+	};
+}
@@ -0,0 +1,120 @@
+#include <cmath>
+
+#include "TestInstancing.h"
+#include "JobSystem.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+static constexpr UniformId u_Texture("u_Texture");
+static constexpr UniformId u_ViewProjection("u_ViewProjection");
+static constexpr UniformId u_Color("u_Color");
+
+static const float s_Positions[] = {
+	-0.5f, -0.5f, 0.0f, 0.0f, // 0 -- bottom left
+	 0.5f, -0.5f, 1.0f, 0.0f, // 1 -- bottom right
+	 0.5f,  0.5f, 1.0f, 1.0f, // 2 -- top right
+	-0.5f,  0.5f, 0.0f, 1.0f  // 3 -- top left
+};
+
+static const unsigned int s_Indices[] = {
+	0, 1, 2,
+	2, 3, 0
+};
+
+namespace test {
+	TestInstancing::TestInstancing()
+		: m_InstanceCount(1000),
+		m_Rotation(0.0f),
+		m_PreviousRotation(0.0f),
+		m_Color(1.0f, 1.0f, 1.0f, 1.0f),
+		m_VertexBuffer(s_Positions, sizeof(s_Positions)),
+		m_InstanceBuffer(MaxInstances * sizeof(glm::mat4)),
+		m_IndexBuffer(s_Indices, 6),
+		m_Shader("Instanced"),
+		m_Texture("res/textures/dice.png")
+	{
+		m_Layout.Push<float>(2); // vertex coordinates
+		m_Layout.Push<float>(2); // texture coordinates
+		m_VertexArray.AddBuffer(m_VertexBuffer, m_Layout);
+
+		m_InstanceLayout.Push<glm::mat4>(1, 1); // model matrix, advances once per instance
+		m_VertexArray.AddBuffer(m_InstanceBuffer, m_InstanceLayout);
+
+		m_Shader.Bind();
+		m_Texture.Bind(0);
+		m_Shader.SetUniform1i(u_Texture, 0);
+
+		m_VertexArray.Unbind();
+		m_IndexBuffer.Unbind();
+		m_Shader.Unbind();
+	}
+
+
+	TestInstancing::~TestInstancing()
+	{
+	}
+
+	void TestInstancing::OnUpdate(float deltaTime)
+	{
+		m_PreviousRotation = m_Rotation;
+		m_Rotation += 0.6f * deltaTime; // radians per second
+	}
+
+	void TestInstancing::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		m_Packet.Clear();
+		m_Packet.WindowX = windowX;
+		m_Packet.WindowY = windowY;
+		m_Packet.Interpolation = renderer.GetInterpolation();
+		OnBuildFrame(m_Packet);
+		OnRenderFrame(renderer, m_Packet);
+	}
+
+	void TestInstancing::OnBuildFrame(FramePacket& packet)
+	{
+		// map projection to pixel space
+		packet.Projection = glm::ortho(0.0f, (float)packet.WindowX, 0.0f, (float)packet.WindowY, -1.0f, 1.0f);
+
+		float rotation = glm::mix(m_PreviousRotation, m_Rotation, packet.Interpolation);
+
+		// Lay the instances out on a square grid over the window
+		int perRow = (int)std::ceil(std::sqrt((float)m_InstanceCount));
+		float cellX = (float)packet.WindowX / perRow;
+		float cellY = (float)packet.WindowY / perRow;
+
+		packet.Transforms.resize(m_InstanceCount);
+		JobSystem::Get().ParallelFor(m_InstanceCount, 256, [&](unsigned int begin, unsigned int end) {
+			for (unsigned int i = begin; i < end; i++)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((i % perRow + 0.5f) * cellX, (i / perRow + 0.5f) * cellY, 0.0f));
+				model = glm::rotate(model, rotation, glm::vec3(0, 0, 1));
+				packet.Transforms[i] = glm::scale(model, glm::vec3(cellX * 0.8f, cellY * 0.8f, 1.0f));
+			}
+		});
+	}
+
+	void TestInstancing::OnRenderFrame(Renderer &renderer, const FramePacket& packet)
+	{
+		unsigned int instanceCount = (unsigned int)packet.Transforms.size();
+		m_InstanceBuffer.SetData(packet.Transforms.data(), instanceCount * sizeof(glm::mat4));
+
+		m_Shader.Bind();
+		m_Shader.SetUniformMatrix4f(u_ViewProjection, packet.Projection);
+		m_Shader.SetUniform4f(u_Color, m_Color.r, m_Color.g, m_Color.b, m_Color.a);
+		m_Texture.Bind(0);
+
+		renderer.DrawInstanced(m_VertexArray, m_IndexBuffer, m_Shader, instanceCount);
+	}
+
+	void TestInstancing::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Instances", &m_InstanceCount, 1, MaxInstances);
+		ImGui::ColorEdit4("color", (float*)&m_Color.r);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
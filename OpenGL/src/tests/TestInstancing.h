@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+#include "FramePacket.h"
+#include "Renderer.h"
+#include "Texture.h"
+
+namespace test {
+	class TestInstancing : public Test
+	{
+	public:
+		static const int MaxInstances = 10000;
+
+		TestInstancing();
+		~TestInstancing();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+
+		bool HasFramePackets() const override { return true; }
+		void OnBuildFrame(FramePacket& packet) override;
+		void OnRenderFrame(Renderer &renderer, const FramePacket& packet) override;
+	private:
+		int m_InstanceCount;
+		float m_Rotation;
+		float m_PreviousRotation;
+		glm::vec4 m_Color;
+
+		FramePacket m_Packet; // when not on the simulation thread
+
+		VertexArray m_VertexArray;
+		VertexBuffer m_VertexBuffer;
+		VertexBufferLayout m_Layout;
+		VertexBuffer m_InstanceBuffer;
+		VertexBufferLayout m_InstanceLayout;
+		IndexBuffer m_IndexBuffer;
+
+		Shader m_Shader;
+		Texture m_Texture;
+	};
+}
@@ -1,16 +1,20 @@
 #include <algorithm>
+#include <cstring>
 
 #include "TestMultipleViewports.h"
+#include "RenderStats.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "imgui/imgui.h"
 
+static constexpr UniformId u_Texture("u_Texture");
+
 namespace test {
 	TestMultipleViewports::TestMultipleViewports()
 		: m_Scale(2.0f),
-		m_Increment(0.05f),
+		m_Increment(3.0f),
 		m_ModelTranslationA(0, 0, 0),
 		m_ModelTranslationB(200, 200, 0),
 		m_View(glm::translate(
@@ -19,6 +23,7 @@ namespace test {
 			glm::vec3(0, 0, 0)    // Noop translation
 		)),
 		m_Color(0.00f, 0.3f, 0.8f, 1.0f),
+		m_PreviousColor(m_Color),
 		m_Positions(new float[16]{
 			// "bottom left square" 960/540 
 			-50.0f * m_Scale, -50.0f * m_Scale, 0.0f, 0.0f, // 0 -- bottom left
@@ -45,9 +50,14 @@ namespace test {
 			2, 3, 0
 		}),
 		m_IndexBuffer(m_Indicies, 6),
-		m_Shader("Basic"),
+		m_Shader("BasicUBO"),
 		//Texture texture("res/textures/dice.png");
-		m_Texture("res/textures/tenor.png")
+		m_Texture("res/textures/tenor.png"),
+		m_ObjectModelOffset(m_ObjectLayout.Push<glm::mat4>()),
+		m_ObjectColorOffset(m_ObjectLayout.Push<glm::vec4>()),
+		m_ObjectStaging(m_ObjectLayout.GetSize()),
+		m_ObjectUniforms(64 * 1024),
+		m_QuadBounds{ glm::vec3(-50.0f * m_Scale, -50.0f * m_Scale, 0.0f), glm::vec3(50.0f * m_Scale, 50.0f * m_Scale, 0.0f) }
 	{
 		// SHould this be in the constructor or in something like an "onLoad" method?
 		m_Layout.Push<float>(2); // vertex coordinates
@@ -55,10 +65,9 @@ namespace test {
 		m_VertexArray.AddBuffer(m_VertexBuffer, m_Layout);
 
 		m_Shader.Bind();
-		m_Shader.SetUniform4f("u_Color", 0.8f, 0.3f, 0.8f, 1.0f);
 
 		m_Texture.Bind(0);
-		m_Shader.SetUniform1i("u_Texture", 0);
+		m_Shader.SetUniform1i(u_Texture, 0);
 
 		// Unbind everything (so we can play around with rebinding before drawing and vaos)
 		m_VertexArray.Unbind();
@@ -74,44 +83,60 @@ namespace test {
 
 	void test::TestMultipleViewports::OnUpdate(float deltaTime)
 	{
+		// Red bounces between 0 and 1, three times a second
 		if (m_Color.r > 1.0f)
-			m_Increment = -0.05f;
+			m_Increment = -3.0f;
 		else if (m_Color.r < 0.0f)
-			m_Increment = 0.05f;
+			m_Increment = 3.0f;
 
-		m_Color.r += m_Increment;
+		m_PreviousColor = m_Color;
+		m_Color.r += m_Increment * deltaTime;
 	}
 
-	void test::TestMultipleViewports::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	unsigned int TestMultipleViewports::SubmitObject(const glm::mat4& model, const glm::vec4& color)
 	{
-		/* Start rebinding stuff we explicity unbound */
-		m_Shader.Bind();
-		m_Shader.SetUniform4f("u_Color", m_Color.r, m_Color.g, m_Color.b, m_Color.a);
+		memcpy(&m_ObjectStaging[m_ObjectModelOffset], &model[0][0], sizeof(glm::mat4));
+		memcpy(&m_ObjectStaging[m_ObjectColorOffset], &color[0], sizeof(glm::vec4));
+		return m_ObjectUniforms.Allocate(m_ObjectStaging.data(), (unsigned int)m_ObjectStaging.size());
+	}
 
+	void test::TestMultipleViewports::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
 		// map projection to pixel space
 		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
 
-		/* Draw instance with "A" translation */
-		{
-			glm::mat4 model = glm::translate( // Move object "up" and to the "right" 200px
-				glm::mat4(1.0f),
-				m_ModelTranslationA
-			); 
-			glm::mat4 mvp = proj * m_View * model;  // right to left (PVM) due to matrix structure in OpenGL
-			m_Shader.SetUniformMatrix4f("u_MVP", mvp);
+		// Projection and view go out once for every program through the "Frame" block
+		renderer.SetFrameData(proj, m_View, (float)glfwGetTime());
 
-			renderer.Draw(m_VertexArray, m_IndexBuffer, m_Shader);
-		}
+		glm::vec4 color = glm::mix(m_PreviousColor, m_Color, renderer.GetInterpolation());
 
-		/* Draw instance againt but with "B" translation */
-		{
-			glm::mat4 model = glm::translate( // Move object "up" and to the "right" 200px
-				glm::mat4(1.0f),
-				m_ModelTranslationB
-			); 
-			glm::mat4 mvp = proj * m_View * model;  // right to left (PVM) due to matrix structure in OpenGL
-			m_Shader.SetUniformMatrix4f("u_MVP", mvp);
+		/* Instance "A" and instance "B", each the same quad at its own translation */
+		const glm::mat4 models[] = {
+			glm::translate(glm::mat4(1.0f), m_ModelTranslationA),
+			glm::translate(glm::mat4(1.0f), m_ModelTranslationB)
+		};
+
+		// Skip the instances that are entirely outside the window
+		m_Culling.Clear();
+		for (const glm::mat4& model : models)
+			m_Culling.Add(m_QuadBounds.Transform(model));
+		m_Culling.Cull(Frustum::FromMatrix(proj * m_View), m_Visible);
+		RenderStats::Get().Add(RenderStats::Visible, m_Visible.size());
+		RenderStats::Get().Add(RenderStats::Culled, m_Culling.GetCount() - m_Visible.size());
+
+		// Stage the visible instances' "Object" blocks and upload them in one go
+		m_ObjectUniforms.Reset();
+		unsigned int objects[2];
+		for (unsigned int index : m_Visible)
+			objects[index] = SubmitObject(models[index], color);
+		m_ObjectUniforms.Upload();
 
+		/* Start rebinding stuff we explicity unbound */
+		m_Shader.Bind();
+
+		for (unsigned int index : m_Visible)
+		{
+			m_ObjectUniforms.BindRange(Renderer::ObjectUniformBinding, objects[index], m_ObjectLayout.GetSize());
 			renderer.Draw(m_VertexArray, m_IndexBuffer, m_Shader);
 		}
 	}
@@ -119,8 +144,10 @@ namespace test {
 	void test::TestMultipleViewports::OnImGuiRender(unsigned int windowX, unsigned int windowY)
 	{
         ImGui::Begin("Debug");                     
-		ImGui::SliderFloat2("A: X & Y", &m_ModelTranslationA.x, 0.0f, std::max((float)windowX, (float)windowY));
-		ImGui::SliderFloat2("B: X & Y", &m_ModelTranslationB.x, 0.0f, std::max((float)windowX, (float)windowY));
+		// Far enough past the edges to move a quad out of view and see it culled
+		ImGui::SliderFloat2("A: X & Y", &m_ModelTranslationA.x, -200.0f, std::max((float)windowX, (float)windowY) + 200.0f);
+		ImGui::SliderFloat2("B: X & Y", &m_ModelTranslationB.x, -200.0f, std::max((float)windowX, (float)windowY) + 200.0f);
+		ImGui::Text("Visible: %u of %u", (unsigned int)m_Visible.size(), m_Culling.GetCount());
 		ImGui::ColorEdit4("color", (float*)&m_Color.r);
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 		ImGui::End();
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Test.h"
+#include "Culling.h"
 #include "Renderer.h"
 #include "Texture.h"
+#include "UniformBuffer.h"
+
+#include <vector>
 
 namespace test {
 	class TestMultipleViewports : public Test
@@ -22,6 +26,7 @@ namespace test {
 		glm::vec3 m_ModelTranslationB;
 		glm::mat4 m_View;
 		glm::vec4 m_Color;
+		glm::vec4 m_PreviousColor;
 
 		float* m_Positions;
 		VertexArray m_VertexArray;
@@ -34,5 +39,19 @@ namespace test {
 		Shader m_Shader;
 		Texture m_Texture;
 
+		// Per-draw "Object" block (model, color), sub-allocated every frame
+		UniformBufferLayout m_ObjectLayout;
+		unsigned int m_ObjectModelOffset;
+		unsigned int m_ObjectColorOffset;
+		std::vector<unsigned char> m_ObjectStaging;
+		DynamicUniformBuffer m_ObjectUniforms;
+
+		// Bounds of the quad in model space, culled per instance every frame
+		BoundingBox m_QuadBounds;
+		CullingSet m_Culling;
+		std::vector<unsigned int> m_Visible;
+
+		unsigned int SubmitObject(const glm::mat4& model, const glm::vec4& color);
+
 	};
 }
@@ -0,0 +1,68 @@
+#include "TestRegistry.h"
+
+#include <cctype>
+
+#include "TestClearColor.h"
+#include "TestMultipleViewports.h"
+#include "TestBatchRendering.h"
+#include "TestInstancing.h"
+#include "TestRenderQueue.h"
+#include "TestAsyncShaders.h"
+#include "TestAsyncTextures.h"
+#include "TestTextureAtlas.h"
+#include "TestTextureArray.h"
+#include "TestTextureStreaming.h"
+
+namespace test {
+	namespace {
+		template<typename T>
+		Test* CreateTest()
+		{
+			return new T();
+		}
+
+		const TestRegistration s_Tests[] = {
+			{ "Multiple Viewports", CreateTest<TestMultipleViewports> },
+			{ "Clear Color",        CreateTest<TestClearColor> },
+			{ "Batch Rendering",    CreateTest<TestBatchRendering> },
+			{ "Instancing",         CreateTest<TestInstancing> },
+			{ "Render Queue",       CreateTest<TestRenderQueue> },
+			{ "Async Shaders",      CreateTest<TestAsyncShaders> },
+			{ "Async Textures",     CreateTest<TestAsyncTextures> },
+			{ "Texture Atlas",      CreateTest<TestTextureAtlas> },
+			{ "Texture Array",      CreateTest<TestTextureArray> },
+			{ "Texture Streaming",  CreateTest<TestTextureStreaming> },
+		};
+
+		bool NamesMatch(const char* a, const char* b)
+		{
+			while (true)
+			{
+				while (*a == ' ')
+					a++;
+				while (*b == ' ')
+					b++;
+				if (!*a || !*b)
+					return !*a && !*b;
+				if (tolower((unsigned char)*a++) != tolower((unsigned char)*b++))
+					return false;
+			}
+		}
+	}
+
+	const TestRegistration* GetTests(size_t& count)
+	{
+		count = sizeof(s_Tests) / sizeof(s_Tests[0]);
+		return s_Tests;
+	}
+
+	const TestRegistration* FindTest(const char* name)
+	{
+		for (const TestRegistration& test : s_Tests)
+		{
+			if (NamesMatch(test.Name, name))
+				return &test;
+		}
+		return nullptr;
+	}
+}
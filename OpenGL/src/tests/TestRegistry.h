@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Test.h"
+
+namespace test {
+	struct TestRegistration
+	{
+		const char* Name;
+		Test* (*Create)();
+	};
+
+	// Every test scene, in the order the test selector lists them
+	const TestRegistration* GetTests(size_t& count);
+
+	// Case insensitive, spaces optional ("batchrendering" finds "Batch Rendering").
+	// Returns null if there is no such test
+	const TestRegistration* FindTest(const char* name);
+}
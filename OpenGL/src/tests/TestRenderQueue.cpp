@@ -0,0 +1,129 @@
+#include <cstdlib>
+
+#include "TestRenderQueue.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+static const float s_QuadPositions[] = {
+	-10.0f, -10.0f, 0.0f, 0.0f, // 0 -- bottom left
+	 10.0f, -10.0f, 1.0f, 0.0f, // 1 -- bottom right
+	 10.0f,  10.0f, 1.0f, 1.0f, // 2 -- top right
+	-10.0f,  10.0f, 0.0f, 1.0f  // 3 -- top left
+};
+static const unsigned int s_QuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+
+static const float s_TrianglePositions[] = {
+	-10.0f, -10.0f, 0.0f, 0.0f, // 0 -- bottom left
+	 10.0f, -10.0f, 1.0f, 0.0f, // 1 -- bottom right
+	  0.0f,  10.0f, 0.5f, 1.0f  // 2 -- top
+};
+static const unsigned int s_TriangleIndices[] = { 0, 1, 2 };
+
+namespace test {
+	TestRenderQueue::TestRenderQueue()
+		: m_ObjectCount(2000),
+		m_SortEnabled(true),
+		m_QuadBuffer(s_QuadPositions, sizeof(s_QuadPositions)),
+		m_TriangleBuffer(s_TrianglePositions, sizeof(s_TrianglePositions)),
+		m_QuadIndices(s_QuadIndices, 6),
+		m_TriangleIndices(s_TriangleIndices, 3),
+		m_ShaderA("Basic"),
+		m_ShaderB("Basic"),
+		m_DiceTexture("res/textures/dice.png"),
+		m_TenorTexture("res/textures/tenor.png")
+	{
+		m_Layout.Push<float>(2); // vertex coordinates
+		m_Layout.Push<float>(2); // texture coordinates
+		m_QuadArray.AddBuffer(m_QuadBuffer, m_Layout);
+		m_TriangleArray.AddBuffer(m_TriangleBuffer, m_Layout);
+
+		m_TriangleArray.Unbind();
+	}
+
+
+	TestRenderQueue::~TestRenderQueue()
+	{
+	}
+
+	void TestRenderQueue::GenerateObjects(unsigned int windowX, unsigned int windowY)
+	{
+		// Deterministic "random" scene where every object picks its mesh and material
+		// independently, so submission order is as bad as it gets for state changes
+		srand(1337);
+		m_Objects.resize(m_ObjectCount);
+		for (Object& object : m_Objects)
+		{
+			object.Position = glm::vec3(rand() % windowX, rand() % windowY, 0.0f);
+			object.Color = glm::vec4((rand() % 256) / 255.0f, (rand() % 256) / 255.0f, (rand() % 256) / 255.0f, 1.0f);
+			object.Mesh = rand() % 2;
+			object.Material = rand() % 4;
+		}
+	}
+
+	void TestRenderQueue::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestRenderQueue::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		m_Packet.Clear();
+		m_Packet.WindowX = windowX;
+		m_Packet.WindowY = windowY;
+		m_Packet.Interpolation = renderer.GetInterpolation();
+		OnBuildFrame(m_Packet);
+		OnRenderFrame(renderer, m_Packet);
+	}
+
+	void TestRenderQueue::OnBuildFrame(FramePacket& packet)
+	{
+		if (m_Objects.size() != (size_t)m_ObjectCount)
+			GenerateObjects(packet.WindowX, packet.WindowY);
+
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)packet.WindowX, 0.0f, (float)packet.WindowY, -1.0f, 1.0f);
+		packet.Projection = proj;
+
+		packet.Draws.reserve(m_Objects.size());
+		for (const Object& object : m_Objects)
+		{
+			DrawPacket draw;
+			draw.Vao = object.Mesh ? &m_TriangleArray : &m_QuadArray;
+			draw.Ibo = object.Mesh ? &m_TriangleIndices : &m_QuadIndices;
+			draw.Program = (object.Material & 1) ? &m_ShaderB : &m_ShaderA;
+			draw.TextureMap = (object.Material & 2) ? &m_TenorTexture : &m_DiceTexture;
+			draw.MVP = proj * glm::translate(glm::mat4(1.0f), object.Position);
+			draw.Color = object.Color;
+			draw.SortKey = RenderQueue::MakeSortKey(0, false, *draw.Program, draw.TextureMap, *draw.Vao, 0.0f);
+
+			packet.Draws.push_back(draw);
+		}
+	}
+
+	void TestRenderQueue::OnRenderFrame(Renderer &renderer, const FramePacket& packet)
+	{
+		m_Queue.Clear();
+		m_Queue.SetSortEnabled(m_SortEnabled);
+		for (const DrawPacket& draw : packet.Draws)
+			m_Queue.Submit(draw);
+		m_Queue.Execute(renderer);
+	}
+
+	void TestRenderQueue::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		const RenderQueue::Stats& stats = m_Queue.GetStats();
+
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Objects", &m_ObjectCount, 1, 20000);
+		ImGui::Checkbox("Sort by key", &m_SortEnabled);
+		ImGui::Text("Draw calls: %u", stats.DrawCalls);
+		ImGui::Text("Program binds: %u", stats.ProgramBinds);
+		ImGui::Text("Vertex array binds: %u", stats.VertexArrayBinds);
+		ImGui::Text("Index buffer binds: %u", stats.IndexBufferBinds);
+		ImGui::Text("Texture binds: %u", stats.TextureBinds);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+#include "FramePacket.h"
+#include "RenderQueue.h"
+#include "Texture.h"
+
+namespace test {
+	class TestRenderQueue : public Test
+	{
+	public:
+		TestRenderQueue();
+		~TestRenderQueue();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+
+		bool HasFramePackets() const override { return true; }
+		void OnBuildFrame(FramePacket& packet) override;
+		void OnRenderFrame(Renderer &renderer, const FramePacket& packet) override;
+	private:
+		struct Object
+		{
+			glm::vec3 Position;
+			glm::vec4 Color;
+			unsigned int Mesh;
+			unsigned int Material;
+		};
+
+		int m_ObjectCount;
+		bool m_SortEnabled;
+		std::vector<Object> m_Objects;
+
+		VertexBuffer m_QuadBuffer;
+		VertexArray m_QuadArray;
+		VertexBuffer m_TriangleBuffer;
+		VertexArray m_TriangleArray;
+		VertexBufferLayout m_Layout;
+		IndexBuffer m_QuadIndices;
+		IndexBuffer m_TriangleIndices;
+
+		// Two programs built from the same source are still two different GL programs
+		Shader m_ShaderA;
+		Shader m_ShaderB;
+		Texture m_DiceTexture;
+		Texture m_TenorTexture;
+
+		RenderQueue m_Queue;
+		FramePacket m_Packet; // when not on the simulation thread
+
+		void GenerateObjects(unsigned int windowX, unsigned int windowY);
+	};
+}
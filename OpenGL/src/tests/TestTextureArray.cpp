@@ -0,0 +1,126 @@
+#include "TestTextureArray.h"
+
+#include <cmath>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+#include "BatchRenderer.h"
+
+static constexpr UniformId u_Textures("u_Textures");
+static constexpr UniformId u_MVP("u_MVP");
+static constexpr UniformId u_Color("u_Color");
+
+namespace test {
+	static const int s_FrameSize = 64;
+
+	// One frame of a spinning bar, each layer a little further round
+	static std::vector<unsigned char> MakeFrame(int frame)
+	{
+		float angle = frame * 3.14159265f / TestTextureArray::LayerCount;
+		glm::vec2 direction(cosf(angle), sinf(angle));
+
+		std::vector<unsigned char> pixels(s_FrameSize * s_FrameSize * 4);
+		for (int y = 0; y < s_FrameSize; y++)
+		{
+			for (int x = 0; x < s_FrameSize; x++)
+			{
+				glm::vec2 p = glm::vec2(x + 0.5f, y + 0.5f) / (float)s_FrameSize - 0.5f;
+				float across = fabsf(p.x * direction.y - p.y * direction.x);
+				bool bar = across < 0.08f && glm::length(p) < 0.45f;
+
+				unsigned char* c = &pixels[(y * s_FrameSize + x) * 4];
+				c[0] = bar ? 255 : 40;
+				c[1] = bar ? (unsigned char)(255 * frame / TestTextureArray::LayerCount) : 40;
+				c[2] = bar ? 64 : 60;
+				c[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	TestTextureArray::TestTextureArray()
+		: m_QuadsPerRow(50),
+		m_Frame(0.0f),
+		m_FramesPerSecond(15.0f),
+		m_Vertices(MaxQuadsPerRow * MaxQuadsPerRow * 4),
+		m_VertexBuffer((unsigned int)(m_Vertices.size() * sizeof(Vertex))),
+		m_IndexBuffer(BatchRenderer::GenerateQuadIndices(MaxQuadsPerRow * MaxQuadsPerRow).data(), MaxQuadsPerRow * MaxQuadsPerRow * 6),
+		m_Shader("BasicArray"),
+		m_Frames(s_FrameSize, s_FrameSize, LayerCount)
+	{
+		m_Layout.Push<float>(2); // vertex coordinates
+		m_Layout.Push<float>(2); // texture coordinates
+		m_Layout.Push<float>(1); // texture array layer
+		m_VertexArray.AddBuffer(m_VertexBuffer, m_Layout);
+
+		for (int i = 0; i < LayerCount; i++)
+			m_Frames.SetLayer(i, MakeFrame(i).data());
+
+		m_Shader.Bind();
+		m_Shader.SetUniform1i(u_Textures, 0);
+
+		m_VertexArray.Unbind();
+		m_IndexBuffer.Unbind();
+		m_Shader.Unbind();
+	}
+
+
+	TestTextureArray::~TestTextureArray()
+	{
+	}
+
+	void TestTextureArray::OnUpdate(float deltaTime)
+	{
+		m_Frame += m_FramesPerSecond * deltaTime;
+	}
+
+	void TestTextureArray::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+
+		float cellX = (float)windowX / m_QuadsPerRow;
+		float cellY = (float)windowY / m_QuadsPerRow;
+
+		// Every quad plays the animation from a different frame, only the layer
+		// attribute changes between them
+		Vertex* v = m_Vertices.data();
+		for (int y = 0; y < m_QuadsPerRow; y++)
+		{
+			for (int x = 0; x < m_QuadsPerRow; x++)
+			{
+				float layer = (float)(((int)m_Frame + x + y) % LayerCount);
+				glm::vec2 min(x * cellX, y * cellY);
+				glm::vec2 max = min + glm::vec2(cellX, cellY) * 0.9f;
+
+				*v++ = { { min.x, min.y }, { 0.0f, 0.0f }, layer };
+				*v++ = { { max.x, min.y }, { 1.0f, 0.0f }, layer };
+				*v++ = { { max.x, max.y }, { 1.0f, 1.0f }, layer };
+				*v++ = { { min.x, max.y }, { 0.0f, 1.0f }, layer };
+			}
+		}
+
+		int quadCount = m_QuadsPerRow * m_QuadsPerRow;
+		m_VertexBuffer.SetData(m_Vertices.data(), quadCount * 4 * sizeof(Vertex));
+
+		m_Shader.Bind();
+		m_Shader.SetUniformMatrix4f(u_MVP, proj);
+		m_Shader.SetUniform4f(u_Color, 1.0f, 1.0f, 1.0f, 1.0f);
+		m_Frames.Bind(0);
+
+		renderer.Draw(m_VertexArray, m_IndexBuffer, m_Shader, quadCount * 6);
+	}
+
+	void TestTextureArray::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Quads per row", &m_QuadsPerRow, 1, MaxQuadsPerRow);
+		ImGui::SliderFloat("Frames per second", &m_FramesPerSecond, 0.0f, 60.0f);
+		ImGui::Text("%d layers of %dx%d, one bind and one draw call", LayerCount, s_FrameSize, s_FrameSize);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
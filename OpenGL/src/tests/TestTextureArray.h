@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+#include "Renderer.h"
+#include "TextureArray.h"
+
+namespace test {
+	class TestTextureArray : public Test
+	{
+	public:
+		static const int MaxQuadsPerRow = 200;
+		static const int LayerCount = 16;
+
+		TestTextureArray();
+		~TestTextureArray();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		struct Vertex
+		{
+			glm::vec2 Position;
+			glm::vec2 TexCoord;
+			float Layer;
+		};
+
+		int m_QuadsPerRow;
+		float m_Frame;
+		float m_FramesPerSecond;
+
+		std::vector<Vertex> m_Vertices;
+
+		VertexArray m_VertexArray;
+		VertexBuffer m_VertexBuffer;
+		VertexBufferLayout m_Layout;
+		IndexBuffer m_IndexBuffer;
+
+		Shader m_Shader;
+		TextureArray m_Frames;
+	};
+}
@@ -0,0 +1,119 @@
+#include "TestTextureAtlas.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+namespace test {
+	static const int s_SpriteCount = 200;
+
+	// Rings of different sizes and colors, so every sprite really is a different image
+	static std::vector<unsigned char> MakeSprite(int index, int& size)
+	{
+		size = 8 + (index * 7) % 41;
+		glm::vec3 color = 0.5f + 0.5f * glm::cos(glm::vec3(0.0f, 2.1f, 4.2f) + index * 0.37f);
+
+		std::vector<unsigned char> pixels(size * size * 4);
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				float dx = (x + 0.5f) / size - 0.5f, dy = (y + 0.5f) / size - 0.5f;
+				float r = sqrtf(dx * dx + dy * dy);
+				bool inside = r < 0.5f && r > 0.15f + 0.2f * (index % 3) / 2.0f;
+
+				unsigned char* p = &pixels[(y * size + x) * 4];
+				p[0] = (unsigned char)(color.r * 255);
+				p[1] = (unsigned char)(color.g * 255);
+				p[2] = (unsigned char)(color.b * 255);
+				p[3] = inside ? 255 : 0;
+			}
+		}
+		return pixels;
+	}
+
+	TestTextureAtlas::TestTextureAtlas()
+		: m_QuadsPerRow(60),
+		m_UseAtlas(true),
+		m_ShowPage(false),
+		m_Atlas(1024, 1024)
+	{
+		const char* files[] = { "res/textures/dice.png", "res/textures/tenor.png" };
+		for (const char* file : files)
+		{
+			// Atlas ids index m_Textures, so a file the atlas skipped is skipped here too
+			if (m_Atlas.Add(file) != -1)
+				m_Textures.emplace_back(new Texture(file, Mipmaps::None));
+		}
+
+		for (int i = 0; i < s_SpriteCount; i++)
+		{
+			int size;
+			std::vector<unsigned char> pixels = MakeSprite(i, size);
+			m_Atlas.Add("sprite" + std::to_string(i), size, size, pixels.data());
+			m_Textures.emplace_back(new Texture(size, size, pixels.data()));
+		}
+
+		m_Atlas.Build();
+	}
+
+
+	TestTextureAtlas::~TestTextureAtlas()
+	{
+	}
+
+	void TestTextureAtlas::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestTextureAtlas::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+
+		float cellX = (float)windowX / m_QuadsPerRow;
+		float cellY = (float)windowY / m_QuadsPerRow;
+
+		m_BatchRenderer.BeginBatch(renderer, proj);
+		for (int y = 0; y < m_QuadsPerRow; y++)
+		{
+			for (int x = 0; x < m_QuadsPerRow; x++)
+			{
+				int image = (y * m_QuadsPerRow + x) % m_Atlas.GetImageCount();
+
+				glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3((x + 0.5f) * cellX, (y + 0.5f) * cellY, 0.0f));
+				transform = glm::scale(transform, glm::vec3(cellX * 0.9f, cellY * 0.9f, 1.0f));
+
+				if (m_UseAtlas)
+					m_BatchRenderer.SubmitQuad(transform, glm::vec4(1.0f), m_Atlas.GetRegion(image).UV, m_Atlas.GetTexture());
+				else
+					m_BatchRenderer.SubmitQuad(transform, glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), m_Textures[image].get());
+			}
+		}
+		m_BatchRenderer.EndBatch();
+	}
+
+	void TestTextureAtlas::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		const BatchRenderer::Stats& stats = m_BatchRenderer.GetStats();
+
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Quads per row", &m_QuadsPerRow, 1, 300);
+		ImGui::Checkbox("Use atlas", &m_UseAtlas);
+		ImGui::Text("%d images, quads: %u, draw calls: %u", m_Atlas.GetImageCount(), stats.QuadCount, stats.DrawCalls);
+		ImGui::Checkbox("Show atlas page", &m_ShowPage);
+		if (m_ShowPage)
+		{
+			// Our textures are stored bottom row first, flip them back for ImGui
+			const Texture* page = m_Atlas.GetTexture();
+			ImGui::Image((ImTextureID)(intptr_t)page->GetRendererID(), ImVec2(256, 256), ImVec2(0, 1), ImVec2(1, 0));
+		}
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
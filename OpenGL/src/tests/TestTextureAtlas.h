@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "TextureAtlas.h"
+
+namespace test {
+	class TestTextureAtlas : public Test
+	{
+	public:
+		TestTextureAtlas();
+		~TestTextureAtlas();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		int m_QuadsPerRow;
+		bool m_UseAtlas;
+		bool m_ShowPage;
+
+		BatchRenderer m_BatchRenderer;
+		TextureAtlas m_Atlas;
+		// The same images as separate textures, to compare against
+		std::vector<std::unique_ptr<Texture>> m_Textures;
+	};
+}
@@ -0,0 +1,80 @@
+#include "TestTextureStreaming.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "imgui/imgui.h"
+
+namespace test {
+	TestTextureStreaming::TestTextureStreaming()
+		: m_Time(0.0f),
+		m_RegionSize(256),
+		m_UsePixelBuffer(true),
+		m_UpdateMilliseconds(0.0f),
+		m_Pixels(TextureSize * TextureSize * 4),
+		m_Texture(TextureSize, TextureSize, nullptr)
+	{
+		// Start from mid grey, the streamed region moves around on top of it
+		std::fill(m_Pixels.begin(), m_Pixels.end(), (unsigned char)128);
+		m_Texture.Update(0, 0, TextureSize, TextureSize, m_Pixels.data());
+	}
+
+
+	TestTextureStreaming::~TestTextureStreaming()
+	{
+	}
+
+	void TestTextureStreaming::OnUpdate(float deltaTime)
+	{
+		m_Time += 1.2f * deltaTime;
+	}
+
+	void TestTextureStreaming::OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY)
+	{
+		// A plasma standing in for a video frame or lightmap, drawn into a region that wanders over the texture
+		int size = m_RegionSize;
+		int x = (int)((TextureSize - size) * (0.5f + 0.5f * sinf(m_Time * 0.7f)));
+		int y = (int)((TextureSize - size) * (0.5f + 0.5f * cosf(m_Time * 0.5f)));
+
+		for (int py = 0; py < size; py++)
+		{
+			for (int px = 0; px < size; px++)
+			{
+				float v = sinf(px * 0.05f + m_Time) + sinf(py * 0.04f - m_Time) + sinf((px + py) * 0.03f + m_Time * 2.0f);
+				unsigned char* c = &m_Pixels[(py * size + px) * 4];
+				c[0] = (unsigned char)(127.5f + 127.5f * sinf(v));
+				c[1] = (unsigned char)(127.5f + 127.5f * sinf(v + 2.1f));
+				c[2] = (unsigned char)(127.5f + 127.5f * sinf(v + 4.2f));
+				c[3] = 255;
+			}
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		m_Texture.Update(x, y, size, size, m_Pixels.data(), m_UsePixelBuffer);
+		m_UpdateMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		// map projection to pixel space
+		glm::mat4 proj = glm::ortho(0.0f, (float)windowX, 0.0f, (float)windowY, -1.0f, 1.0f);
+		float side = (float)std::min(windowX, windowY) * 0.9f;
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(windowX * 0.5f, windowY * 0.5f, 0.0f));
+		transform = glm::scale(transform, glm::vec3(side, side, 1.0f));
+
+		m_BatchRenderer.BeginBatch(renderer, proj);
+		m_BatchRenderer.SubmitQuad(transform, glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), &m_Texture);
+		m_BatchRenderer.EndBatch();
+	}
+
+	void TestTextureStreaming::OnImGuiRender(unsigned int windowX, unsigned int windowY)
+	{
+		ImGui::Begin("Debug");
+		ImGui::SliderInt("Region size", &m_RegionSize, 16, TextureSize);
+		ImGui::Checkbox("Upload through a pixel buffer", &m_UsePixelBuffer);
+		ImGui::Text("Update(): %.3f ms for %.1f KB", m_UpdateMilliseconds, m_RegionSize * m_RegionSize * 4 / 1024.0f);
+		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		ImGui::End();
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "Texture.h"
+
+namespace test {
+	class TestTextureStreaming : public Test
+	{
+	public:
+		static const int TextureSize = 512;
+
+		TestTextureStreaming();
+		~TestTextureStreaming();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender(Renderer &renderer, unsigned int windowX, unsigned int windowY) override;
+		void OnImGuiRender(unsigned int windowX, unsigned int windowY) override;
+	private:
+		float m_Time;
+		int m_RegionSize;
+		bool m_UsePixelBuffer;
+		float m_UpdateMilliseconds;
+
+		std::vector<unsigned char> m_Pixels;
+
+		BatchRenderer m_BatchRenderer;
+		Texture m_Texture;
+	};
+}
@@ -0,0 +1,310 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+	const int BlockPixels = 16;
+
+	// Finds the line through the block's colors that best fits them, using the first
+	// `channels` channels. Returns the two ends of the colors' spread along it.
+	void FindEndpoints(const unsigned char* rgba, int channels, float* end0, float* end1)
+	{
+		float mean[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < BlockPixels; i++)
+			for (int c = 0; c < channels; c++)
+				mean[c] += rgba[i * 4 + c];
+		for (int c = 0; c < channels; c++)
+			mean[c] /= BlockPixels;
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < BlockPixels; i++)
+		{
+			float d[4];
+			for (int c = 0; c < channels; c++)
+				d[c] = rgba[i * 4 + c] - mean[c];
+			for (int a = 0; a < channels; a++)
+				for (int b = 0; b < channels; b++)
+					covariance[a][b] += d[a] * d[b];
+		}
+
+		// Power iteration converges on the principal axis quickly enough for 4x4 pixels
+		float axis[4] = { 1, 1, 1, 1 };
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = { 0, 0, 0, 0 };
+			float length = 0;
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = 0; b < channels; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, fabsf(next[a]));
+			}
+			if (length == 0)
+				break;
+			for (int c = 0; c < channels; c++)
+				axis[c] = next[c] / length;
+		}
+
+		float minT = 0, maxT = 0;
+		for (int i = 0; i < BlockPixels; i++)
+		{
+			float t = 0, axisLength = 0;
+			for (int c = 0; c < channels; c++)
+			{
+				t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+				axisLength += axis[c] * axis[c];
+			}
+			if (axisLength > 0)
+				t /= axisLength;
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			end0[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * maxT));
+			end1[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * minT));
+		}
+	}
+
+	inline uint16_t Pack565(const float* color)
+	{
+		int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+		int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+		int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	inline void Unpack565(uint16_t color, int* out)
+	{
+		int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+		out[0] = (r << 3) | (r >> 2);
+		out[1] = (g << 2) | (g >> 4);
+		out[2] = (b << 3) | (b >> 2);
+	}
+
+	// Writes the low `bits` of value at the current position, least significant bit first
+	struct BitWriter
+	{
+		unsigned char* Out;
+		unsigned int Position;
+
+		void Write(uint32_t value, unsigned int bits)
+		{
+			for (unsigned int i = 0; i < bits; i++, Position++)
+				if (value & (1u << i))
+					Out[Position / 8] |= (unsigned char)(1u << (Position % 8));
+		}
+	};
+}
+
+void EncodeBlockBC1(const unsigned char* rgba, unsigned char* out)
+{
+	float end0[4], end1[4];
+	FindEndpoints(rgba, 3, end0, end1);
+
+	uint16_t color0 = Pack565(end0);
+	uint16_t color1 = Pack565(end1);
+
+	// color0 > color1 selects the four color mode, the three color one would
+	// spend an index on transparent black
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		Unpack565(color0, palette[0]);
+		Unpack565(color1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (int i = 0; i < BlockPixels; i++)
+		{
+			int best = 0, bestError = INT32_MAX;
+			for (int p = 0; p < 4; p++)
+			{
+				int error = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int d = rgba[i * 4 + c] - palette[p][c];
+					error += d * d;
+				}
+				if (error < bestError)
+					best = p, bestError = error;
+			}
+			indices |= (uint32_t)best << (i * 2);
+		}
+	}
+
+	memcpy(out, &color0, 2);
+	memcpy(out + 2, &color1, 2);
+	memcpy(out + 4, &indices, 4);
+}
+
+void EncodeBlockBC4(const unsigned char* rgba, unsigned char* out, int channel /*= 0*/)
+{
+	int high = 0, low = 255;
+	for (int i = 0; i < BlockPixels; i++)
+	{
+		high = std::max(high, (int)rgba[i * 4 + channel]);
+		low = std::min(low, (int)rgba[i * 4 + channel]);
+	}
+
+	memset(out, 0, 8);
+	out[0] = (unsigned char)high;
+	out[1] = (unsigned char)low;
+	if (high == low)
+		return;
+
+	// high > low selects the mode with six interpolated values between the two
+	int palette[8] = { high, low };
+	for (int p = 1; p < 7; p++)
+		palette[p + 1] = ((7 - p) * high + p * low) / 7;
+
+	BitWriter bits = { out + 2, 0 };
+	for (int i = 0; i < BlockPixels; i++)
+	{
+		int value = rgba[i * 4 + channel];
+		int best = 0;
+		for (int p = 1; p < 8; p++)
+			if (abs(palette[p] - value) < abs(palette[best] - value))
+				best = p;
+		bits.Write(best, 3);
+	}
+}
+
+void EncodeBlockBC3(const unsigned char* rgba, unsigned char* out)
+{
+	EncodeBlockBC4(rgba, out, 3);
+	EncodeBlockBC1(rgba, out + 8);
+}
+
+void EncodeBlockBC5(const unsigned char* rgba, unsigned char* out)
+{
+	EncodeBlockBC4(rgba, out, 0);
+	EncodeBlockBC4(rgba, out + 8, 1);
+}
+
+void EncodeBlockBC7(const unsigned char* rgba, unsigned char* out)
+{
+	static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	float ends[2][4];
+	FindEndpoints(rgba, 4, ends[0], ends[1]);
+
+	// Mode 6 endpoints are 7 bits per channel plus one low bit shared by the
+	// whole endpoint, pick whichever p-bit gets closer
+	int quantized[2][4], pbits[2];
+	int endpoints[2][4];
+	for (int e = 0; e < 2; e++)
+	{
+		int bestError = INT32_MAX;
+		for (int p = 0; p < 2; p++)
+		{
+			int q[4], error = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				q[c] = std::min(127, std::max(0, (int)((ends[e][c] - p) / 2.0f + 0.5f)));
+				int d = ((q[c] << 1) | p) - (int)(ends[e][c] + 0.5f);
+				error += d * d;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				pbits[e] = p;
+				memcpy(quantized[e], q, sizeof(q));
+			}
+		}
+		for (int c = 0; c < 4; c++)
+			endpoints[e][c] = (quantized[e][c] << 1) | pbits[e];
+	}
+
+	int indices[BlockPixels];
+	for (int i = 0; i < BlockPixels; i++)
+	{
+		int best = 0, bestError = INT32_MAX;
+		for (int w = 0; w < 16; w++)
+		{
+			int error = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				int value = ((64 - weights[w]) * endpoints[0][c] + weights[w] * endpoints[1][c] + 32) >> 6;
+				int d = rgba[i * 4 + c] - value;
+				error += d * d;
+			}
+			if (error < bestError)
+				best = w, bestError = error;
+		}
+		indices[i] = best;
+	}
+
+	// The first index is stored without its top bit, so it has to be below 8
+	if (indices[0] >= 8)
+	{
+		std::swap(quantized[0], quantized[1]);
+		std::swap(pbits[0], pbits[1]);
+		for (int i = 0; i < BlockPixels; i++)
+			indices[i] = 15 - indices[i];
+	}
+
+	memset(out, 0, 16);
+	BitWriter bits = { out, 0 };
+	bits.Write(1 << 6, 7); // mode 6
+	for (int c = 0; c < 4; c++)
+	{
+		bits.Write(quantized[0][c], 7);
+		bits.Write(quantized[1][c], 7);
+	}
+	bits.Write(pbits[0], 1);
+	bits.Write(pbits[1], 1);
+	bits.Write(indices[0], 3);
+	for (int i = 1; i < BlockPixels; i++)
+		bits.Write(indices[i], 4);
+}
+
+std::vector<unsigned char> CompressLevel(const unsigned char* rgba, int width, int height, CompressedFormat format)
+{
+	unsigned int blockSize = CompressedImage::GetBlockSize(format);
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+
+	std::vector<unsigned char> out(blocksX * blocksY * blockSize);
+	unsigned char block[BlockPixels * 4];
+
+	for (int by = 0; by < blocksY; by++)
+	{
+		for (int bx = 0; bx < blocksX; bx++)
+		{
+			for (int y = 0; y < 4; y++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					int sx = std::min(bx * 4 + x, width - 1);
+					int sy = std::min(by * 4 + y, height - 1);
+					memcpy(block + (y * 4 + x) * 4, rgba + (sy * width + sx) * 4, 4);
+				}
+			}
+
+			unsigned char* dst = out.data() + (by * blocksX + bx) * blockSize;
+			switch (format)
+			{
+			case CompressedFormat::BC1: EncodeBlockBC1(block, dst); break;
+			case CompressedFormat::BC3: EncodeBlockBC3(block, dst); break;
+			case CompressedFormat::BC4: EncodeBlockBC4(block, dst); break;
+			case CompressedFormat::BC5: EncodeBlockBC5(block, dst); break;
+			case CompressedFormat::BC7: EncodeBlockBC7(block, dst); break;
+			default: return {};
+			}
+		}
+	}
+	return out;
+}
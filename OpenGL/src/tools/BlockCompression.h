@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "TextureContainer.h"
+
+/**
+ * CPU encoders for the BCn block formats, used by the offline texture compressor.
+ *
+ * Each block encoder takes 4x4 RGBA8 pixels, row by row, and writes one compressed
+ * block. They go for a decent result quickly (principal axis endpoints, best index
+ * per pixel), not for the best quality an exhaustive search could find.
+ */
+void EncodeBlockBC1(const unsigned char* rgba, unsigned char* out);
+void EncodeBlockBC3(const unsigned char* rgba, unsigned char* out);
+// Encodes a single channel (0 = red ... 3 = alpha)
+void EncodeBlockBC4(const unsigned char* rgba, unsigned char* out, int channel = 0);
+void EncodeBlockBC5(const unsigned char* rgba, unsigned char* out);
+// Only uses mode 6 (one RGBA endpoint pair, 4 bit indices)
+void EncodeBlockBC7(const unsigned char* rgba, unsigned char* out);
+
+// Compresses a whole RGBA8 level, partial blocks at the edges repeat the last row/column
+std::vector<unsigned char> CompressLevel(const unsigned char* rgba, int width, int height, CompressedFormat format);
@@ -0,0 +1,99 @@
+#include "Tools.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "stb_image/stb_image.h"
+
+#include "BlockCompression.h"
+#include "MipGenerator.h"
+#include "TextureContainer.h"
+
+int CompressTextureTool(int argc, char** argv)
+{
+	if (argc < 2)
+		return 2;
+
+	std::string input = argv[0];
+	std::string output = argv[1];
+	CompressedImage image;
+	image.Format = CompressedFormat::BC7;
+	bool mips = true;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+		{
+			std::string format = argv[++i];
+			if (format == "bc1") image.Format = CompressedFormat::BC1;
+			else if (format == "bc3") image.Format = CompressedFormat::BC3;
+			else if (format == "bc4") image.Format = CompressedFormat::BC4;
+			else if (format == "bc5") image.Format = CompressedFormat::BC5;
+			else if (format == "bc7") image.Format = CompressedFormat::BC7;
+			else return 2;
+		}
+		else if (strcmp(argv[i], "--srgb") == 0)
+			image.Srgb = true;
+		else if (strcmp(argv[i], "--no-mips") == 0)
+			mips = false;
+		else
+			return 2;
+	}
+
+	if (image.Srgb && (image.Format == CompressedFormat::BC4 || image.Format == CompressedFormat::BC5))
+	{
+		std::cout << "BC4/BC5 have no sRGB variant" << std::endl;
+		return 1;
+	}
+
+	// Flip like Texture does, so the compressed file uploads as is
+	int width, height, bpp;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &bpp, 4);
+	if (!pixels)
+	{
+		std::cout << "Could not load '" << input << "': " << stbi_failure_reason() << std::endl;
+		return 1;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// The encoder sees the same gamma-correct levels Texture would build for Mipmaps::Cpu
+	MipChain chain;
+	if (mips)
+	{
+		chain = GenerateMipChain(pixels, width, height, image.Srgb);
+	}
+	else
+	{
+		chain.Data.assign(pixels, pixels + width * height * 4);
+		chain.Levels.push_back({ width, height, 0 });
+	}
+	stbi_image_free(pixels);
+
+	image.Width = width;
+	image.Height = height;
+	for (size_t i = 0; i < chain.Levels.size(); i++)
+	{
+		const MipLevel& level = chain.Levels[i];
+		std::vector<unsigned char> blocks = CompressLevel(chain.GetLevelData(i), level.Width, level.Height, image.Format);
+		image.Levels.push_back({ level.Width, level.Height, (unsigned int)image.Data.size(), (unsigned int)blocks.size() });
+		image.Data.insert(image.Data.end(), blocks.begin(), blocks.end());
+	}
+
+	float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+
+	if (!WriteCompressedImage(output, image))
+	{
+		std::cout << "Could not write '" << output << "'" << std::endl;
+		return 1;
+	}
+
+	std::cout << input << " (" << image.Width << "x" << image.Height << ", " << image.Width * image.Height * 4 / 1024 << " KB)"
+		<< " -> " << output << " (" << image.Levels.size() << " levels, " << image.Data.size() / 1024 << " KB) in "
+		<< seconds * 1000.0f << " ms" << std::endl;
+	return 0;
+}
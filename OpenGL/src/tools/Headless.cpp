@@ -0,0 +1,84 @@
+#include "Tools.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "AssetArchive.h"
+#include "Benchmark.h"
+
+bool ParseBenchmarkOption(int argc, char** argv, int& i, BenchmarkSettings& settings)
+{
+	if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		settings.Frames = atoi(argv[++i]);
+	else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+		settings.Warmup = atoi(argv[++i]);
+	else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &settings.Width, &settings.Height) == 2)
+		i++;
+	else if (strcmp(argv[i], "--no-egl") == 0)
+		settings.AllowEgl = false;
+	else if (strcmp(argv[i], "--no-gpu") == 0)
+		settings.MeasureGpu = false;
+	else if (strcmp(argv[i], "--hash") == 0)
+		settings.Hash = true;
+	else
+		return false;
+	return settings.Frames >= 1 && settings.Warmup >= 0 && settings.Width >= 1 && settings.Height >= 1;
+}
+
+const test::TestRegistration* FindTestOrListAll(const char* name)
+{
+	const test::TestRegistration* registration = test::FindTest(name);
+	if (!registration)
+	{
+		std::cout << "No test named '" << name << "', the tests are:" << std::endl;
+		size_t count;
+		const test::TestRegistration* tests = test::GetTests(count);
+		for (size_t i = 0; i < count; i++)
+			std::cout << "  " << tests[i].Name << std::endl;
+	}
+	return registration;
+}
+
+int HeadlessTool(int argc, char** argv)
+{
+	if (argc < 1)
+		return 2;
+
+	BenchmarkSettings settings;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!ParseBenchmarkOption(argc, argv, i, settings))
+			return 2;
+	}
+
+	const test::TestRegistration* registration = FindTestOrListAll(argv[0]);
+	if (!registration)
+		return 1;
+
+	AssetArchive assets;
+	if (assets.Open("assets.pak"))
+		AssetArchive::Mount(&assets);
+
+	BenchmarkResult result;
+	if (!RunBenchmark(*registration, settings, result))
+		return 1;
+
+	BenchmarkDistribution frame = BenchmarkDistribution::FromSamples(result.FrameMs);
+	BenchmarkDistribution submit = BenchmarkDistribution::FromSamples(result.SubmitMs);
+	BenchmarkDistribution gpu = BenchmarkDistribution::FromSamples(result.GpuMs);
+	printf("Context:  %s\n", result.Renderer.c_str());
+	printf("Test:     %s, %d frames (+%d warmup) at %dx%d\n", result.Test.c_str(), settings.Frames, settings.Warmup, settings.Width, settings.Height);
+	printf("Frame:    avg %.3f ms, min %.3f ms, max %.3f ms (%.1f FPS)\n", frame.Mean, frame.Min, frame.Max, 1000.0 / frame.Mean);
+	printf("Submit:   avg %.3f ms, min %.3f ms, max %.3f ms\n", submit.Mean, submit.Min, submit.Max);
+	if (gpu.Samples)
+		printf("GPU:      avg %.3f ms, min %.3f ms, max %.3f ms\n", gpu.Mean, gpu.Min, gpu.Max);
+	printf("Per frame: %.1f draws, %.0f indices, %.1f program binds, %.1f texture binds, %.1f KB uploaded\n",
+		result.Counters[RenderStats::DrawCalls], result.Counters[RenderStats::Indices],
+		result.Counters[RenderStats::ProgramBinds], result.Counters[RenderStats::TextureBinds],
+		(result.Counters[RenderStats::BufferBytes] + result.Counters[RenderStats::TextureBytes]) / 1024.0);
+	if (settings.Hash)
+		printf("Hash:     %016llx\n", (unsigned long long)result.Hash);
+	return 0;
+}
@@ -0,0 +1,123 @@
+#include "Tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "JobSystem.h"
+
+namespace {
+	struct Workload
+	{
+		const char* Name;
+		std::function<void(unsigned int, unsigned int)> Body;
+	};
+
+	// Best of `iterations` runs, in milliseconds
+	double Time(int iterations, const std::function<void()>& run)
+	{
+		double best = 1e30;
+		for (int i = 0; i < iterations; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			run();
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best;
+	}
+}
+
+int JobsTool(int argc, char** argv)
+{
+	unsigned int workers = 0;
+	unsigned int count = 100000;
+	unsigned int grain = 0;
+	int iterations = 20;
+	for (int i = 0; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+			workers = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+			count = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--grain") == 0 && i + 1 < argc)
+			grain = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+			iterations = atoi(argv[++i]);
+		else
+			return 2;
+	}
+	if (count == 0 || iterations < 1)
+		return 2;
+
+	JobSystem jobs(workers);
+	printf("%u workers + the calling thread, %u items, best of %d runs\n\n", jobs.GetWorkerCount(), count, iterations);
+
+	// Instance transforms like TestInstancing builds every frame, light per item
+	std::vector<glm::mat4> transforms(count), expectedTransforms(count);
+	auto buildTransforms = [&transforms](unsigned int begin, unsigned int end) {
+		for (unsigned int i = begin; i < end; i++)
+		{
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3((float)(i % 100), (float)(i / 100), 0.0f));
+			model = glm::rotate(model, i * 0.01f, glm::vec3(0, 0, 1));
+			transforms[i] = glm::scale(model, glm::vec3(8.0f, 8.0f, 1.0f));
+		}
+	};
+
+	// Something closer to decoding or generating vertices, heavier per item
+	std::vector<float> samples(count), expectedSamples(count);
+	auto computeSamples = [&samples](unsigned int begin, unsigned int end) {
+		for (unsigned int i = begin; i < end; i++)
+		{
+			float value = 0.0f;
+			for (int octave = 1; octave <= 64; octave++)
+				value += sinf(i * 0.001f * octave) / octave;
+			samples[i] = value;
+		}
+	};
+
+	Workload workloads[] = {
+		{ "transforms", buildTransforms },
+		{ "noise", computeSamples },
+	};
+
+	std::vector<unsigned int> grains;
+	if (grain)
+		grains.push_back(grain);
+	else
+		grains = { 16, 64, 256, 1024, 4096 };
+
+	// Each run starts from zeroed outputs and has to match the serial run exactly
+	auto clearOutputs = [&] {
+		std::fill(transforms.begin(), transforms.end(), glm::mat4(0.0f));
+		std::fill(samples.begin(), samples.end(), 0.0f);
+	};
+
+	bool ok = true;
+	for (Workload& workload : workloads)
+	{
+		clearOutputs();
+		double serial = Time(iterations, [&] { workload.Body(0, count); });
+		expectedTransforms = transforms;
+		expectedSamples = samples;
+		printf("%-10s serial        %9.3f ms\n", workload.Name, serial);
+
+		for (unsigned int g : grains)
+		{
+			clearOutputs();
+			double parallel = Time(iterations, [&] { jobs.ParallelFor(count, g, workload.Body); });
+			bool same = transforms == expectedTransforms && samples == expectedSamples;
+			ok &= same;
+			printf("%-10s grain %-7u %9.3f ms  %5.2fx%s\n", workload.Name, g, parallel, serial / parallel, same ? "" : "  MISMATCH");
+		}
+		printf("\n");
+	}
+	return ok ? 0 : 1;
+}
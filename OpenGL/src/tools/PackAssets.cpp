@@ -0,0 +1,187 @@
+#include "Tools.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "AssetArchive.h"
+#include "Lz4.h"
+
+namespace {
+	// Appends every file under path (or path itself if it is a file), always with forward slashes
+	void ListFiles(const std::string& path, std::vector<std::string>& files)
+	{
+#ifdef _WIN32
+		DWORD attributes = GetFileAttributesA(path.c_str());
+		if (attributes == INVALID_FILE_ATTRIBUTES)
+			return;
+		if (!(attributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			files.push_back(path);
+			return;
+		}
+
+		WIN32_FIND_DATAA found;
+		HANDLE search = FindFirstFileA((path + "/*").c_str(), &found);
+		if (search == INVALID_HANDLE_VALUE)
+			return;
+		do
+		{
+			if (strcmp(found.cFileName, ".") != 0 && strcmp(found.cFileName, "..") != 0)
+				ListFiles(path + "/" + found.cFileName, files);
+		} while (FindNextFileA(search, &found));
+		FindClose(search);
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0)
+			return;
+		if (!S_ISDIR(info.st_mode))
+		{
+			files.push_back(path);
+			return;
+		}
+
+		DIR* dir = opendir(path.c_str());
+		if (!dir)
+			return;
+		while (dirent* found = readdir(dir))
+		{
+			if (strcmp(found->d_name, ".") != 0 && strcmp(found->d_name, "..") != 0)
+				ListFiles(path + "/" + found->d_name, files);
+		}
+		closedir(dir);
+#endif
+	}
+
+	bool ReadFile(const std::string& path, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+			return false;
+		fseek(file, 0, SEEK_END);
+		data.resize(ftell(file));
+		fseek(file, 0, SEEK_SET);
+		bool read = data.empty() || fread(data.data(), 1, data.size(), file) == data.size();
+		fclose(file);
+		return read;
+	}
+
+	inline size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+int PackAssetsTool(int argc, char** argv)
+{
+	if (argc < 2)
+		return 2;
+
+	std::string output = argv[0];
+	std::vector<std::string> files;
+	bool compress = false;
+	uint32_t alignment = 16;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--lz4") == 0)
+			compress = true;
+		else if (strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+			alignment = (uint32_t)atoi(argv[++i]);
+		else
+			ListFiles(argv[i], files);
+	}
+
+	// A power of two keeps the views usable for aligned (SIMD) reads
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		return 2;
+
+	std::sort(files.begin(), files.end());
+	files.erase(std::unique(files.begin(), files.end()), files.end());
+
+	std::vector<AssetArchive::Entry> entries;
+	std::vector<std::vector<unsigned char>> blobs;
+	std::string names;
+	size_t totalSize = 0;
+
+	for (const std::string& file : files)
+	{
+		std::vector<unsigned char> data;
+		if (!ReadFile(file, data))
+		{
+			std::cout << "Could not read '" << file << "'" << std::endl;
+			return 1;
+		}
+
+		AssetArchive::Entry entry = {};
+		entry.Size = (uint32_t)data.size();
+		entry.NameOffset = (uint32_t)names.size();
+		entry.NameLength = (uint32_t)file.size();
+		names += file;
+		totalSize += data.size();
+
+		// Only worth decompressing at load time if it saves a good chunk,
+		// which already compressed images never do
+		if (compress)
+		{
+			std::vector<unsigned char> packed = Lz4Compress(data.data(), data.size());
+			if (packed.size() < data.size() * 9 / 10)
+			{
+				data.swap(packed);
+				entry.Flags |= AssetArchive::Lz4Compressed;
+			}
+		}
+		entry.StoredSize = (uint32_t)data.size();
+
+		entries.push_back(entry);
+		blobs.push_back(std::move(data));
+	}
+
+	size_t offset = sizeof(AssetArchive::Header) + entries.size() * sizeof(AssetArchive::Entry) + names.size();
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		offset = AlignUp(offset, alignment);
+		entries[i].Offset = offset;
+		offset += blobs[i].size();
+	}
+
+	AssetArchive::Header header = { AssetArchive::Magic, AssetArchive::Version, (uint32_t)entries.size(), alignment };
+
+	FILE* out = fopen(output.c_str(), "wb");
+	if (!out)
+	{
+		std::cout << "Could not write '" << output << "'" << std::endl;
+		return 1;
+	}
+
+	fwrite(&header, sizeof(header), 1, out);
+	if (!entries.empty())
+		fwrite(entries.data(), sizeof(AssetArchive::Entry), entries.size(), out);
+	fwrite(names.data(), 1, names.size(), out);
+
+	const std::vector<unsigned char> padding(alignment, 0);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		fwrite(padding.data(), 1, (size_t)entries[i].Offset - ftell(out), out);
+		fwrite(blobs[i].data(), 1, blobs[i].size(), out);
+	}
+
+	bool written = ferror(out) == 0;
+	fclose(out);
+
+	std::cout << output << ": " << entries.size() << " assets, " << totalSize / 1024 << " KB -> " << offset / 1024 << " KB" << std::endl;
+	return written ? 0 : 1;
+}
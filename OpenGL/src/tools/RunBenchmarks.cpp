@@ -0,0 +1,73 @@
+#include "Tools.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Benchmark.h"
+
+int BenchmarkTool(int argc, char** argv)
+{
+	BenchmarkSettings settings;
+	std::string jsonPath, csvPath, label;
+	std::vector<const test::TestRegistration*> tests;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+			label = argv[++i];
+		else if (strncmp(argv[i], "--", 2) == 0)
+		{
+			if (!ParseBenchmarkOption(argc, argv, i, settings))
+				return 2;
+		}
+		else
+		{
+			const test::TestRegistration* test = FindTestOrListAll(argv[i]);
+			if (!test)
+				return 1;
+			tests.push_back(test);
+		}
+	}
+
+	// No names runs everything
+	if (tests.empty())
+	{
+		size_t count;
+		const test::TestRegistration* all = test::GetTests(count);
+		for (size_t i = 0; i < count; i++)
+			tests.push_back(&all[i]);
+	}
+
+	AssetArchive assets;
+	if (assets.Open("assets.pak"))
+		AssetArchive::Mount(&assets);
+
+	std::vector<BenchmarkResult> results;
+	printf("%-20s %9s %9s %9s %9s %9s\n", "test", "mean ms", "p50", "p95", "p99", "gpu p50");
+	for (const test::TestRegistration* test : tests)
+	{
+		BenchmarkResult result;
+		if (!RunBenchmark(*test, settings, result))
+			return 1;
+
+		BenchmarkDistribution frame = BenchmarkDistribution::FromSamples(result.FrameMs);
+		BenchmarkDistribution gpu = BenchmarkDistribution::FromSamples(result.GpuMs);
+		printf("%-20s %9.3f %9.3f %9.3f %9.3f %9.3f\n", test->Name, frame.Mean, frame.P50, frame.P95, frame.P99, gpu.P50);
+		results.push_back(std::move(result));
+	}
+
+	bool ok = true;
+	if (!jsonPath.empty())
+		ok &= WriteBenchmarkJson(jsonPath, label, settings, results);
+	if (!csvPath.empty())
+		ok &= WriteBenchmarkCsv(csvPath, label, results);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#include "Tools.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+	struct Tool
+	{
+		const char* Name;
+		int(*Main)(int argc, char** argv);
+		const char* Usage;
+	};
+
+	const Tool s_Tools[] = {
+		{ "compress-texture", CompressTextureTool, "<input.png> <output.dds|.ktx2> [--format bc1|bc3|bc4|bc5|bc7] [--srgb] [--no-mips]" },
+		{ "pack-assets",      PackAssetsTool,      "<output.pak> <files or directories...> [--lz4] [--align N]" },
+		{ "headless",         HeadlessTool,        "<test name> [--frames N] [--warmup N] [--size WxH] [--no-egl] [--no-gpu] [--hash]" },
+		{ "benchmark",        BenchmarkTool,       "[test names...] [--json out.json] [--csv out.csv] [--label text] [headless options]" },
+		{ "jobs",             JobsTool,            "[--workers N] [--count N] [--grain N] [--iterations N]" },
+	};
+}
+
+bool RunTool(int argc, char** argv, int& exitCode)
+{
+	if (argc < 2)
+		return false;
+
+	if (strcmp(argv[1], "tools") == 0)
+	{
+		for (const Tool& tool : s_Tools)
+			std::cout << tool.Name << " " << tool.Usage << std::endl;
+		exitCode = 0;
+		return true;
+	}
+
+	for (const Tool& tool : s_Tools)
+	{
+		if (strcmp(argv[1], tool.Name) == 0)
+		{
+			exitCode = tool.Main(argc - 2, argv + 2);
+			if (exitCode == 2)
+				std::cout << "usage: " << tool.Name << " " << tool.Usage << std::endl;
+			return true;
+		}
+	}
+	return false;
+}
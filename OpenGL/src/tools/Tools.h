@@ -0,0 +1,25 @@
+#pragma once
+
+struct BenchmarkSettings;
+namespace test { struct TestRegistration; }
+
+/**
+ * Command line tools built into the executable. Running `OpenGL.exe <tool> [args...]`
+ * runs the tool instead of opening the window, `OpenGL.exe tools` lists them.
+ */
+
+// Returns false if argv[1] doesn't name a tool, otherwise runs it and sets exitCode
+bool RunTool(int argc, char** argv, int& exitCode);
+
+// Each tool gets the arguments after its name
+int CompressTextureTool(int argc, char** argv);
+int PackAssetsTool(int argc, char** argv);
+int HeadlessTool(int argc, char** argv);
+int BenchmarkTool(int argc, char** argv);
+int JobsTool(int argc, char** argv);
+
+// Shared by the headless and benchmark tools, defined in Headless.cpp:
+// applies the option at argv[i] (moving i past its value), false if it isn't one or is invalid
+bool ParseBenchmarkOption(int argc, char** argv, int& i, BenchmarkSettings& settings);
+// and looks up a test, printing the registered names if none matches
+const test::TestRegistration* FindTestOrListAll(const char* name);